@@ -0,0 +1,400 @@
+#include "bench.h"
+
+#define BENCH_SEED 20240601ULL
+#define POSITION_COUNT 256
+#define DEFAULT_SAMPLES 41
+#define DEFAULT_TOLERANCE 0.30
+#define MIN_SAMPLE_NS 200000.0
+#define MAX_BENCHMARKS 32
+#define NAME_LENGTH 48
+
+typedef struct {
+  GameData_t game;
+  GameData_t board_template;
+  CurrentPiece_t positions[POSITION_COUNT];
+  Rng_t policy;
+  unsigned cursor;
+} BenchState_t;
+
+typedef void (*BenchFn_t)(BenchState_t *state, long iterations);
+
+typedef struct {
+  char name[NAME_LENGTH];
+  long iterations;
+  double min, p50, p90, p99, mean;
+} BenchResult_t;
+
+static volatile long sink;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Заполняет нижнюю часть поля случайными блоками.
+ *
+ * Поле детерминировано начальным значением BENCH_SEED, поэтому все
+ * запуски измеряют одну и ту же работу.
+ * @param game Игра, поле которой заполняется.
+ * @param rng Генератор для выбора ячеек.
+ */
+static void fill_fixed_board(GameData_t *game, Rng_t *rng) {
+  for (int y = BOARD_HEIGHT / 2; y < BOARD_HEIGHT; y++) {
+    for (int x = 0; x < BOARD_WIDTH; x++) {
+      if (rng_below(rng, 3)) set_board_cell(game, x, y, 1 + x % 7);
+    }
+  }
+}
+
+/**
+ * @brief Подготавливает игру, поле и набор положений фигур для замеров.
+ *
+ * @param state Состояние бенчмарков.
+ * @param full_rows Сколько нижних строк поля сделать заполненными.
+ */
+static void prepare_state(BenchState_t *state, int full_rows) {
+  Rng_t rng;
+  rng_seed(&rng, BENCH_SEED);
+  initialize_game_core(&state->game, 0, BENCH_SEED);
+  fill_fixed_board(&state->game, &rng);
+  for (int y = BOARD_HEIGHT - full_rows; y < BOARD_HEIGHT; y++) {
+    for (int x = 0; x < BOARD_WIDTH; x++) set_board_cell(&state->game, x, y, 1);
+  }
+  state->board_template = state->game;
+
+  for (int i = 0; i < POSITION_COUNT; i++) {
+    state->positions[i] = (CurrentPiece_t){
+        (int)rng_below(&rng, PIECE_COUNT), (int)rng_below(&rng, 4),
+        (int)rng_below(&rng, 14) - 3, (int)rng_below(&rng, 24) - 3, 1};
+  }
+  state->game.current_piece = (CurrentPiece_t){2, 0, SPAWN_X, 2, 3};
+  rng_seed(&state->policy, ~BENCH_SEED);
+  state->cursor = 0;
+}
+
+static void bench_check_collision(BenchState_t *state, long iterations) {
+  long hits = 0;
+  for (long i = 0; i < iterations; i++) {
+    state->game.current_piece =
+        state->positions[state->cursor++ % POSITION_COUNT];
+    hits += check_collision(&state->game);
+  }
+  sink = hits;
+}
+
+static void bench_rotate_piece(BenchState_t *state, long iterations) {
+  for (long i = 0; i < iterations; i++) rotate_piece(&state->game);
+  sink = state->game.current_piece.rotation;
+}
+
+static void bench_move_piece(BenchState_t *state, long iterations) {
+  for (long i = 0; i < iterations; i++) {
+    move_piece(&state->game, (i & 2) ? 1 : -1, 0);
+  }
+  sink = state->game.current_piece.x;
+}
+
+/**
+ * @brief Замер clear_lines; поле восстанавливается перед каждым вызовом.
+ *
+ * Время операции включает копирование строк, цветов, высот столбцов,
+ * маски полных строк и хэша поля (262 байта), иначе после первого
+ * вызова очищать было бы нечего.
+ * @param state Состояние бенчмарков.
+ * @param iterations Количество операций.
+ */
+static void bench_clear_lines(BenchState_t *state, long iterations) {
+  long cleared = 0;
+  for (long i = 0; i < iterations; i++) {
+    memcpy(state->game.rows, state->board_template.rows,
+           sizeof(state->game.rows));
+    memcpy(state->game.board, state->board_template.board,
+           sizeof(state->game.board));
+    memcpy(state->game.heights, state->board_template.heights,
+           sizeof(state->game.heights));
+    state->game.full_rows = state->board_template.full_rows;
+    state->game.hash = state->board_template.hash;
+    cleared += clear_lines(&state->game);
+  }
+  sink = cleared;
+}
+
+/**
+ * @brief Замер расчета падения для сброса фигуры с высоты появления.
+ *
+ * @param state Состояние бенчмарков.
+ * @param iterations Количество операций.
+ */
+static void bench_drop_distance(BenchState_t *state, long iterations) {
+  long total = 0;
+  for (long i = 0; i < iterations; i++) {
+    CurrentPiece_t piece = state->positions[state->cursor++ % POSITION_COUNT];
+    const PieceRotation_t *rotation = piece_rotation(&piece);
+    if (piece.x < rotation->min_x) piece.x = rotation->min_x;
+    if (piece.x > rotation->max_x) piece.x = rotation->max_x;
+    piece.y = SPAWN_Y;
+    state->game.current_piece = piece;
+    total += drop_distance(&state->game);
+  }
+  sink = total;
+}
+
+static void bench_imprint_piece(BenchState_t *state, long iterations) {
+  for (long i = 0; i < iterations; i++) imprint_piece_to_board(&state->game);
+  sink = state->game.rows[BOARD_HEIGHT - 1];
+}
+
+/**
+ * @brief Замер полного цикла кадра: действие игрока и шаг автомата.
+ *
+ * Действия выбираются детерминированной случайной политикой, после
+ * окончания игры она начинается заново с тем же начальным значением.
+ * @param state Состояние бенчмарков.
+ * @param iterations Количество кадров.
+ */
+static void bench_game_cycle(BenchState_t *state, long iterations) {
+  static const UserAction_t actions[8] = {
+      ActionNone,      ActionNone,      ActionNone,   ActionMoveLeft,
+      ActionMoveRight, ActionRotate,    ActionRotate, ActionMoveDown};
+  for (long i = 0; i < iterations; i++) {
+    if (state->game.state == GameOver) {
+      initialize_game_core(&state->game, 0, BENCH_SEED);
+    }
+    UserAction_t action = state->game.state == Start
+                              ? ActionStart
+                              : actions[rng_below(&state->policy, 8)];
+    apply_user_action(&state->game, action);
+    update_game_state(&state->game);
+  }
+  sink = state->game.info.score;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+  double left = *(const double *)a, right = *(const double *)b;
+  return (left > right) - (left < right);
+}
+
+/**
+ * @brief Выполняет один бенчмарк и собирает распределение ns/op.
+ *
+ * Число операций в выборке подбирается удвоением так, чтобы выборка
+ * длилась не меньше MIN_SAMPLE_NS; затем снимается samples выборок.
+ * @param name Имя бенчмарка.
+ * @param fn Функция бенчмарка.
+ * @param full_rows Количество заполненных строк в подготовленном поле.
+ * @param samples Количество выборок.
+ * @return BenchResult_t Статистика по выборкам.
+ */
+static BenchResult_t run_benchmark(const char *name, BenchFn_t fn,
+                                   int full_rows, int samples) {
+  static BenchState_t state;
+  prepare_state(&state, full_rows);
+
+  long iterations = 1;
+  for (;;) {
+    double started = now_ns();
+    fn(&state, iterations);
+    if (now_ns() - started >= MIN_SAMPLE_NS) break;
+    iterations *= 2;
+  }
+
+  double per_op[samples];
+  double sum = 0;
+  for (int i = 0; i < samples; i++) {
+    double started = now_ns();
+    fn(&state, iterations);
+    per_op[i] = (now_ns() - started) / (double)iterations;
+    sum += per_op[i];
+  }
+  qsort(per_op, (size_t)samples, sizeof(double), compare_doubles);
+
+  BenchResult_t result = {.iterations = iterations};
+  snprintf(result.name, sizeof(result.name), "%s", name);
+  result.min = per_op[0];
+  result.p50 = per_op[(samples - 1) * 50 / 100];
+  result.p90 = per_op[(samples - 1) * 90 / 100];
+  result.p99 = per_op[(samples - 1) * 99 / 100];
+  result.mean = sum / samples;
+  return result;
+}
+
+/**
+ * @brief Записывает результаты в JSON, по одному бенчмарку на строку.
+ *
+ * @param path Путь к файлу.
+ * @param results Результаты бенчмарков.
+ * @param count Количество результатов.
+ * @return int 0 при успехе, -1 при ошибке записи.
+ */
+static int write_json(const char *path, const BenchResult_t *results,
+                      int count) {
+  FILE *file = fopen(path, "w");
+  if (!file) return -1;
+
+  fprintf(file, "{\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [\n");
+  for (int i = 0; i < count; i++) {
+    const BenchResult_t *r = &results[i];
+    fprintf(file,
+            "    {\"name\": \"%s\", \"iterations\": %ld, \"min\": %.3f, "
+            "\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"mean\": %.3f}%s\n",
+            r->name, r->iterations, r->min, r->p50, r->p90, r->p99, r->mean,
+            i + 1 < count ? "," : "");
+  }
+  fprintf(file, "  ]\n}\n");
+  return fclose(file) == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Читает медианы из файла, записанного write_json.
+ *
+ * @param path Путь к файлу эталона.
+ * @param baseline Буфер для прочитанных записей (используются name и p50).
+ * @return int Количество прочитанных записей или -1, если файла нет.
+ */
+static int read_baseline(const char *path, BenchResult_t *baseline) {
+  FILE *file = fopen(path, "r");
+  if (!file) return -1;
+
+  int count = 0;
+  char line[512];
+  while (count < MAX_BENCHMARKS && fgets(line, sizeof(line), file)) {
+    const char *name = strstr(line, "\"name\": \"");
+    const char *p50 = strstr(line, "\"p50\": ");
+    if (!name || !p50) continue;
+    if (sscanf(name + 9, "%47[^\"]", baseline[count].name) == 1 &&
+        sscanf(p50 + 7, "%lf", &baseline[count].p50) == 1) {
+      count++;
+    }
+  }
+  fclose(file);
+  return count;
+}
+
+/**
+ * @brief Сравнивает медианы с эталоном и печатает отношение.
+ *
+ * @param results Текущие результаты.
+ * @param count Количество текущих результатов.
+ * @param baseline Эталонные результаты.
+ * @param baseline_count Количество эталонных результатов.
+ * @param tolerance Допустимое относительное замедление (0.3 = 30%).
+ * @return int Количество бенчмарков, замедлившихся сильнее допуска.
+ */
+static int compare_with_baseline(const BenchResult_t *results, int count,
+                                 const BenchResult_t *baseline,
+                                 int baseline_count, double tolerance) {
+  int regressions = 0;
+  printf("\n%-28s %10s %10s %8s\n", "vs baseline", "base p50", "p50",
+         "ratio");
+  for (int i = 0; i < count; i++) {
+    const BenchResult_t *base = NULL;
+    for (int j = 0; j < baseline_count && !base; j++) {
+      if (!strcmp(baseline[j].name, results[i].name)) base = &baseline[j];
+    }
+    if (!base || base->p50 <= 0) {
+      printf("%-28s %10s %10.2f %8s\n", results[i].name, "-", results[i].p50,
+             "new");
+      continue;
+    }
+    double ratio = results[i].p50 / base->p50;
+    bool regressed = ratio > 1.0 + tolerance;
+    regressions += regressed;
+    printf("%-28s %10.2f %10.2f %7.2fx%s\n", results[i].name, base->p50,
+           results[i].p50, ratio, regressed ? "  REGRESSION" : "");
+  }
+  return regressions;
+}
+
+static void print_usage(const char *name) {
+  fprintf(stderr,
+          "Usage: %s [-n samples] [-o output.json] [-b baseline.json] "
+          "[-r tolerance]\n",
+          name);
+}
+
+int main(int argc, char **argv) {
+  int samples = DEFAULT_SAMPLES;
+  double tolerance = DEFAULT_TOLERANCE;
+  const char *output = NULL;
+  const char *baseline_path = NULL;
+
+  int option;
+  while ((option = getopt(argc, argv, "n:o:b:r:h")) != -1) {
+    switch (option) {
+      case 'n':
+        samples = (int)strtol(optarg, NULL, 10);
+        break;
+      case 'o':
+        output = optarg;
+        break;
+      case 'b':
+        baseline_path = optarg;
+        break;
+      case 'r':
+        tolerance = strtod(optarg, NULL);
+        break;
+      default:
+        print_usage(argv[0]);
+        return option == 'h' ? 0 : 1;
+    }
+  }
+  if (samples < 1 || tolerance < 0) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  struct {
+    const char *name;
+    BenchFn_t fn;
+    int full_rows;
+  } const benchmarks[] = {
+      {"check_collision", bench_check_collision, 0},
+      {"rotate_piece", bench_rotate_piece, 0},
+      {"move_piece", bench_move_piece, 0},
+      {"clear_lines/0", bench_clear_lines, 0},
+      {"clear_lines/1", bench_clear_lines, 1},
+      {"clear_lines/2", bench_clear_lines, 2},
+      {"clear_lines/3", bench_clear_lines, 3},
+      {"clear_lines/4", bench_clear_lines, 4},
+      {"imprint_piece_to_board", bench_imprint_piece, 0},
+      {"drop_distance", bench_drop_distance, 0},
+      {"update_game_state_cycle", bench_game_cycle, 0},
+  };
+  int count = (int)(sizeof(benchmarks) / sizeof(benchmarks[0]));
+
+  BenchResult_t results[MAX_BENCHMARKS];
+  printf("%-28s %10s %10s %10s %10s %10s\n", "benchmark (ns/op)", "min",
+         "p50", "p90", "p99", "mean");
+  for (int i = 0; i < count; i++) {
+    results[i] = run_benchmark(benchmarks[i].name, benchmarks[i].fn,
+                               benchmarks[i].full_rows, samples);
+    printf("%-28s %10.2f %10.2f %10.2f %10.2f %10.2f\n", results[i].name,
+           results[i].min, results[i].p50, results[i].p90, results[i].p99,
+           results[i].mean);
+  }
+
+  if (output && write_json(output, results, count) != 0) {
+    fprintf(stderr, "Failed to write %s\n", output);
+    return 1;
+  }
+
+  if (baseline_path) {
+    BenchResult_t baseline[MAX_BENCHMARKS];
+    int baseline_count = read_baseline(baseline_path, baseline);
+    if (baseline_count < 0) {
+      fprintf(stderr, "Baseline %s not found, skipping comparison\n",
+              baseline_path);
+      return 0;
+    }
+    int regressions = compare_with_baseline(results, count, baseline,
+                                            baseline_count, tolerance);
+    if (regressions > 0) {
+      fprintf(stderr, "%d benchmark(s) regressed by more than %.0f%%\n",
+              regressions, tolerance * 100);
+      return 1;
+    }
+  }
+  return 0;
+}
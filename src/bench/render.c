@@ -0,0 +1,183 @@
+#include "render.h"
+
+#define DEFAULT_REPEATS 5
+#define BACKEND_COUNT 4
+
+typedef struct {
+  const char *name;
+  long frames;
+  size_t bytes;
+  long ghost_recomputes;
+  double elapsed;
+} RenderResult_t;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Продвигает игру на ticks тиков и рисует каждый непустой тик.
+ *
+ * Пустые тики пропускаются так же, как в advance_game, а кадр
+ * выводится после каждого вызова update_game_state — столько же кадров
+ * рисует интерактивный цикл, который просыпается только к событиям.
+ * @param game Указатель на главную структуру данных игры.
+ * @param ticks Количество тиков.
+ * @param renderer Вывод.
+ */
+static void advance_and_draw(GameData_t *game, long ticks,
+                             Renderer_t *renderer) {
+  while (ticks > 0 && !game->info.pause) {
+    long before = game->timer.tick;
+    ticks -= skip_to_tick(game, before + ticks) - before;
+    if (ticks > 0) {
+      update_game_state(game);
+      ticks--;
+      renderer->draw(renderer, game);
+    }
+  }
+}
+
+/**
+ * @brief Повторяет запись, отрисовывая ее выбранным выводом.
+ *
+ * Кадр выводится после каждой пачки действий одного тика и после каждого
+ * тика, на котором игра изменилась сама.
+ * @param path Путь к файлу записи.
+ * @param renderer Инициализированный вывод.
+ * @return bool false, если запись не удалось прочитать.
+ */
+static bool render_replay(const char *path, Renderer_t *renderer) {
+  ReplayReader_t reader;
+  if (!replay_open(&reader, path)) return false;
+  GameData_t game;
+  replay_start_game(&reader, &game);
+  renderer->draw(renderer, &game);
+
+  long tick = 0, event_tick = 0;
+  UserAction_t action = ActionNone;
+  bool pending = replay_next(&reader, &event_tick, &action);
+  for (;;) {
+    bool acted = false;
+    while (pending && event_tick == tick) {
+      replay_apply(&reader, &game, action);
+      acted = true;
+      pending = replay_next(&reader, &event_tick, &action);
+    }
+    if (acted) renderer->draw(renderer, &game);
+    long target = pending ? event_tick : reader.tick;
+    advance_and_draw(&game, target - tick, renderer);
+    tick = target;
+    if (!pending) break;
+  }
+  replay_close(&reader);
+  return true;
+}
+
+/**
+ * @brief Создает вывод с номером index для замеров.
+ *
+ * Терминальные выводы пишут не в терминал: ncurses — во временный файл,
+ * ANSI — в /dev/null, чтобы замер не зависел от скорости эмулятора.
+ * @return bool false, если вывод не удалось подготовить.
+ */
+static bool make_renderer(int index, Renderer_t *renderer,
+                          Offscreen_t *screen, FILE *ncurses_output,
+                          int null_fd, size_t budget) {
+  switch (index) {
+    case 0:
+      null_renderer(renderer);
+      return true;
+    case 1:
+      offscreen_renderer(renderer, screen);
+      return true;
+    case 2:
+      ansi_view_renderer(renderer, null_fd, budget);
+      return renderer->state != NULL;
+    default:
+      rewind(ncurses_output);
+      ncurses_renderer(renderer, ncurses_output);
+      return renderer->state != NULL;
+  }
+}
+
+static void print_usage(const char *name) {
+  fprintf(stderr, "Usage: %s [-n repeats] [-b frame_bytes] replay...\n",
+          name);
+}
+
+int main(int argc, char **argv) {
+  int repeats = DEFAULT_REPEATS;
+  size_t budget = 0;
+  int option;
+  while ((option = getopt(argc, argv, "n:b:h")) != -1) {
+    switch (option) {
+      case 'n':
+        repeats = (int)strtol(optarg, NULL, 10);
+        break;
+      case 'b':
+        budget = strtoul(optarg, NULL, 10);
+        break;
+      default:
+        print_usage(argv[0]);
+        return option == 'h' ? 0 : 1;
+    }
+  }
+  if (repeats < 1 || optind >= argc) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  static Offscreen_t screen;
+  FILE *ncurses_output = tmpfile();
+  int null_fd = open("/dev/null", O_WRONLY);
+  if (!ncurses_output || null_fd < 0) {
+    fprintf(stderr, "Failed to open render outputs\n");
+    return 1;
+  }
+
+  RenderResult_t results[BACKEND_COUNT] = {{0}};
+  int status = 0;
+  for (int backend = 0; backend < BACKEND_COUNT && !status; backend++) {
+    for (int pass = 0; pass < repeats && !status; pass++) {
+      for (int i = optind; i < argc && !status; i++) {
+        Renderer_t renderer;
+        if (!make_renderer(backend, &renderer, &screen, ncurses_output,
+                           null_fd, budget) ||
+            !renderer.init(&renderer)) {
+          fprintf(stderr, "Failed to initialize renderer %d\n", backend);
+          status = 1;
+          break;
+        }
+        double started = now_ns();
+        bool ok = render_replay(argv[i], &renderer);
+        results[backend].elapsed += now_ns() - started;
+        results[backend].name = renderer.name;
+        results[backend].frames += renderer.frames;
+        results[backend].bytes += renderer.bytes;
+        results[backend].ghost_recomputes += renderer.ghost.recomputes;
+        renderer.cleanup(&renderer);
+        if (!ok) {
+          fprintf(stderr, "Failed to read replay %s\n", argv[i]);
+          status = 1;
+        }
+      }
+    }
+  }
+  fclose(ncurses_output);
+  close(null_fd);
+  if (status) return status;
+
+  printf("%-10s %10s %12s %12s %12s %10s\n", "backend", "frames",
+         "frames/s", "bytes", "bytes/frame", "ghost");
+  for (int i = 0; i < BACKEND_COUNT; i++) {
+    const RenderResult_t *result = &results[i];
+    printf("%-10s %10ld %12.0f %12zu %12.1f %10ld\n", result->name,
+           result->frames, (double)result->frames * 1e9 / result->elapsed,
+           result->bytes, (double)result->bytes / (double)result->frames,
+           result->ghost_recomputes);
+  }
+  return 0;
+}
@@ -0,0 +1,12 @@
+#define _DEFAULT_SOURCE
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "brickgame/tetris/recorder.h"
+#include "gui/cli/ansi_view.h"
+#include "gui/cli/renderer.h"
+#include "gui/cli/view.h"
\ No newline at end of file
@@ -0,0 +1,393 @@
+#include "brickgame/tetris/ai.h"
+
+const AiWeights_t AI_DEFAULT_WEIGHTS = {-510, 761, -357, -184};
+
+/**
+ * @brief Создает автоигрока с лучевым поиском (beam search).
+ *
+ * Вся память поиска (лучи, кандидаты, рабочие области генератора ходов и
+ * стеки отмены по одному на поток) выделяется здесь один раз, поэтому
+ * ходы не запрашивают память.
+ * @param width Ширина луча: сколько лучших полей переходит на следующий
+ * уровень (от 1 до AI_BEAM_MAX).
+ * @param depth Число фигур в поиске: текущая и depth - 1 фигур
+ * предпросмотра (от 1 до AI_DEPTH_MAX).
+ * @param threads Число потоков, на которых раскрывается луч.
+ * @return AiPlayer_t* Автоигрок или NULL при нехватке памяти.
+ */
+AiPlayer_t *ai_create(int width, int depth, int threads) {
+  AiPlayer_t *ai = calloc(1, sizeof(AiPlayer_t));
+  if (ai == NULL) return NULL;
+
+  if (width < 1) width = 1;
+  if (width > AI_BEAM_MAX) width = AI_BEAM_MAX;
+  if (depth < 1) depth = 1;
+  if (depth > AI_DEPTH_MAX) depth = AI_DEPTH_MAX;
+  if (threads < 1) threads = 1;
+  ai->weights = AI_DEFAULT_WEIGHTS;
+  ai->width = width;
+  ai->depth = depth;
+  ai->threads = threads;
+
+  size_t slots = (size_t)width * (size_t)width;
+  ai->beam = calloc((size_t)width, sizeof(AiNode_t));
+  ai->next = calloc((size_t)width, sizeof(AiNode_t));
+  ai->children = calloc(slots, sizeof(AiChild_t));
+  ai->ranked = calloc(slots, sizeof(AiChild_t));
+  ai->child_counts = calloc((size_t)width, sizeof(int));
+  ai->gens = calloc((size_t)threads, sizeof(MoveGen_t));
+  ai->stacks = calloc((size_t)threads, sizeof(UndoStack_t));
+  if (!ai->beam || !ai->next || !ai->children || !ai->ranked ||
+      !ai->child_counts || !ai->gens || !ai->stacks) {
+    ai_destroy(ai);
+    return NULL;
+  }
+  return ai;
+}
+
+/**
+ * @brief Освобождает автоигрока.
+ *
+ * @param ai Автоигрок (NULL допускается).
+ */
+void ai_destroy(AiPlayer_t *ai) {
+  if (ai == NULL) return;
+  free(ai->beam);
+  free(ai->next);
+  free(ai->children);
+  free(ai->ranked);
+  free(ai->child_counts);
+  free(ai->gens);
+  free(ai->stacks);
+  free(ai);
+}
+
+/**
+ * @brief Вычисляет признаки поля для оценки позиции.
+ *
+ * Суммарная высота и неровность (сумма перепадов высот соседних
+ * столбцов) берутся из поддерживаемых движком высот столбцов. Дырки —
+ * пустые клетки под верхним блоком своего столбца — считаются по битовым
+ * строкам сверху вниз: маска накрытых столбцов накапливается, и в каждой
+ * строке подсчитываются накрытые пустые клетки.
+ * @param game Игра, поле которой оценивается.
+ * @param features Куда записать признаки.
+ */
+void ai_features(const GameData_t *game, AiFeatures_t *features) {
+  *features = (AiFeatures_t){0, 0, 0};
+  for (int x = 0; x < BOARD_WIDTH; x++) {
+    features->height += game->heights[x];
+    if (x > 0) {
+      features->bumpiness += abs(game->heights[x] - game->heights[x - 1]);
+    }
+  }
+
+  uint16_t covered = 0;
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    features->holes += __builtin_popcount(covered & ~game->rows[y]);
+    covered |= game->rows[y];
+  }
+}
+
+/**
+ * @brief Оценивает поле линейной комбинацией признаков.
+ *
+ * @param game Игра, поле которой оценивается.
+ * @param weights Веса признаков.
+ * @param lines Число линий, очищенных на пути к этому полю.
+ * @return int64_t Оценка; чем больше, тем лучше поле.
+ */
+int64_t ai_evaluate(const GameData_t *game, const AiWeights_t *weights,
+                    int lines) {
+  AiFeatures_t features;
+  ai_features(game, &features);
+  return weights->height * features.height + weights->lines * lines +
+         weights->holes * features.holes +
+         weights->bumpiness * features.bumpiness;
+}
+
+/**
+ * @brief Вставляет кандидата в упорядоченный список лучших потомков узла.
+ *
+ * Список упорядочен по убыванию оценки; при равенстве раньше остается
+ * кандидат, найденный раньше. Больше width потомков одного узла в луч
+ * попасть не может, поэтому остальные отбрасываются.
+ * @param slot Список потомков узла.
+ * @param kept Текущая длина списка.
+ * @param width Ширина луча.
+ * @param child Новый кандидат.
+ * @return int Новая длина списка.
+ */
+static int keep_child(AiChild_t *slot, int kept, int width,
+                      const AiChild_t *child) {
+  int i = kept < width ? kept : width - 1;
+  if (kept == width && slot[i].value >= child->value) return kept;
+  while (i > 0 && slot[i - 1].value < child->value) {
+    slot[i] = slot[i - 1];
+    i--;
+  }
+  slot[i] = *child;
+  return kept < width ? kept + 1 : kept;
+}
+
+/**
+ * @brief Раскрывает один узел луча; задача для пула потоков.
+ *
+ * Перебирает все положения фигуры текущего уровня, для каждого фиксирует
+ * фигуру через журнал отмены, оценивает поле и откатывает ход. Узлы луча
+ * раскрываются независимо: поток пишет только в поле своего узла (которое
+ * возвращается в исходное состояние) и в его часть массива потомков, а
+ * рабочие области берет по номеру потока.
+ * @param context Указатель на AiPlayer_t.
+ * @param worker Номер потока.
+ * @param index Номер узла в луче.
+ */
+static void expand_node(void *context, int worker, int64_t index) {
+  AiPlayer_t *ai = context;
+  AiNode_t *node = &ai->beam[index];
+  MoveGen_t *gen = &ai->gens[worker];
+  UndoStack_t *stack = &ai->stacks[worker];
+  AiChild_t *slot = &ai->children[index * ai->width];
+
+  int count = ai->ply == 0
+                  ? generate_placements(gen, &node->game,
+                                        &node->game.current_piece)
+                  : generate_spawn_placements(gen, &node->game, ai->piece);
+  int kept = 0;
+  undo_reset(stack);
+  for (int i = 0; i < count; i++) {
+    if (!undo_place_piece(stack, &node->game, placement_piece(gen, i))) {
+      break;
+    }
+    AiChild_t child = {placement_piece(gen, i), node->game.hash, 0,
+                       node->lines +
+                           __builtin_popcount(stack->entries[0].cleared),
+                       (int)index, i};
+    child.value = ai_evaluate(&node->game, &ai->weights, child.lines);
+    undo_restore(stack, &node->game);
+    kept = keep_child(slot, kept, ai->width, &child);
+  }
+  ai->child_counts[index] = kept;
+}
+
+static int compare_children(const void *a, const void *b) {
+  const AiChild_t *left = a, *right = b;
+  if (left->value != right->value) return left->value < right->value ? 1 : -1;
+  if (left->parent != right->parent) return left->parent - right->parent;
+  return left->order - right->order;
+}
+
+/**
+ * @brief Собирает следующий луч из лучших потомков всех узлов.
+ *
+ * Потомки упорядочиваются по оценке, а при равенстве — по номеру узла и
+ * порядку генерации, поэтому результат не зависит от числа потоков и
+ * порядка выполнения задач. Поля с одинаковым хэшем Зобриста (одно поле,
+ * полученное разными порядками расстановок) берутся один раз, чтобы луч
+ * не заполнялся повторами.
+ * @param ai Автоигрок после раскрытия всех узлов луча.
+ * @return int Число узлов в новом луче (в ai->next).
+ */
+static int select_beam(AiPlayer_t *ai) {
+  int total = 0;
+  for (int i = 0; i < ai->beam_count; i++) {
+    memcpy(&ai->ranked[total], &ai->children[i * ai->width],
+           sizeof(AiChild_t) * (size_t)ai->child_counts[i]);
+    total += ai->child_counts[i];
+  }
+  qsort(ai->ranked, (size_t)total, sizeof(AiChild_t), compare_children);
+
+  int count = 0;
+  for (int i = 0; i < total && count < ai->width; i++) {
+    const AiChild_t *child = &ai->ranked[i];
+    bool seen = false;
+    for (int j = 0; j < count && !seen; j++) {
+      seen = ai->next[j].game.hash == child->hash;
+    }
+    if (seen) continue;
+
+    const AiNode_t *parent = &ai->beam[child->parent];
+    AiNode_t *node = &ai->next[count++];
+    node->game = parent->game;
+    node->game.current_piece = child->piece;
+    imprint_piece_to_board(&node->game);
+    process_scoring_and_levelup(&node->game);
+    node->first = ai->ply == 0 ? child->piece : parent->first;
+    node->value = child->value;
+    node->lines = child->lines;
+  }
+  return count;
+}
+
+/**
+ * @brief Выбирает положение текущей фигуры лучевым поиском.
+ *
+ * На уровне 0 перебираются положения текущей фигуры из ее нынешнего
+ * положения, на следующих — положения фигур предпросмотра
+ * (preview_piece) из точки появления. После каждого уровня в луче
+ * остаются width лучших полей. Узлы луча раскрываются параллельно через
+ * ai->parallel (с пулом ai->runner, которым владеет вызывающий код), если
+ * оно задано и потоков больше одного, иначе по очереди
+ * в вызывающем потоке; результат от этого не зависит. Если на каком-то
+ * уровне положений не нашлось, выбор делается по предыдущему уровню.
+ * @param ai Автоигрок.
+ * @param game Игра в состоянии Moving.
+ * @param best Куда записать выбранное конечное положение текущей фигуры.
+ * @return bool false, если у текущей фигуры нет ни одного положения.
+ */
+bool ai_search(AiPlayer_t *ai, const GameData_t *game, CurrentPiece_t *best) {
+  ai->beam[0] = (AiNode_t){*game, game->current_piece, 0, 0};
+  ai->beam_count = 1;
+  bool found = false;
+
+  for (ai->ply = 0; ai->ply < ai->depth; ai->ply++) {
+    if (ai->ply > 0) {
+      ai->piece = preview_piece(game, ai->ply - 1);
+      if (ai->piece < 0) break;
+    }
+    if (ai->parallel != NULL && ai->threads > 1) {
+      ai->parallel(ai->runner, ai->threads, ai->beam_count, expand_node, ai);
+    } else {
+      for (int i = 0; i < ai->beam_count; i++) expand_node(ai, 0, i);
+    }
+
+    int count = select_beam(ai);
+    if (count == 0) break;
+    AiNode_t *swap = ai->beam;
+    ai->beam = ai->next;
+    ai->next = swap;
+    ai->beam_count = count;
+    found = true;
+  }
+
+  if (found) *best = ai->beam[0].first;
+  return found;
+}
+
+static bool same_piece(const CurrentPiece_t *a, const CurrentPiece_t *b) {
+  return a->piece == b->piece && a->rotation == b->rotation &&
+         a->x == b->x && a->y == b->y;
+}
+
+/**
+ * @brief Строит путь "повороты и сдвиги наверху, затем жесткое падение".
+ *
+ * Ходы проверяются на копии игры через apply_user_action, поэтому путь
+ * заведомо выполним. Подходит, если конечное положение достижимо прямым
+ * падением (без подсовывания под нависающие блоки).
+ * @param ai Автоигрок; путь записывается в ai->path.
+ * @param game Игра в состоянии Moving.
+ * @param target Конечное положение фигуры.
+ * @param rotate_first Поворачивать до сдвигов или после.
+ * @return bool true, если путь найден.
+ */
+static bool direct_path(AiPlayer_t *ai, const GameData_t *game,
+                        const CurrentPiece_t *target, bool rotate_first) {
+  GameData_t copy = *game;
+  CurrentPiece_t *piece = &copy.current_piece;
+  int length = 0;
+  for (int pass = 0; pass < 2; pass++) {
+    bool rotating = (pass == 0) == rotate_first;
+    while (length < AI_PATH_MAX - 1) {
+      UserAction_t action;
+      if (rotating && piece->rotation != target->rotation)
+        action = ActionRotate;
+      else if (!rotating && piece->x != target->x)
+        action = piece->x < target->x ? ActionMoveRight : ActionMoveLeft;
+      else
+        break;
+      CurrentPiece_t before = *piece;
+      apply_user_action(&copy, action);
+      if (same_piece(&before, piece)) return false;
+      ai->path[length++] = action;
+    }
+  }
+
+  CurrentPiece_t landed = *piece;
+  landed.y += drop_distance(&copy);
+  if (!same_piece(&landed, target)) return false;
+  ai->path[length++] = ActionMoveDown;
+  ai->length = length;
+  return true;
+}
+
+/**
+ * @brief Выбирает положение текущей фигуры и строит путь к нему.
+ *
+ * Сначала пробуется прямой путь (direct_path): он не ждет гравитации и
+ * выполняется за один тик. Для положений под нависающими блоками берется
+ * кратчайший путь генератора ходов, в котором ActionNone означает
+ * ожидание шага гравитации.
+ * @param ai Автоигрок.
+ * @param game Игра в состоянии Moving.
+ */
+static void plan_move(AiPlayer_t *ai, const GameData_t *game) {
+  ai->planned = true;
+  ai->piece_count = game->piece_count;
+  ai->expected = game->current_piece;
+  ai->step = 0;
+  ai->length = 0;
+  ai->plans++;
+
+  CurrentPiece_t target;
+  if (!ai_search(ai, game, &target)) return;
+  if (direct_path(ai, game, &target, true) ||
+      direct_path(ai, game, &target, false)) {
+    return;
+  }
+
+  MoveGen_t *gen = &ai->gens[0];
+  int count = generate_placements(gen, game, &game->current_piece);
+  for (int i = 0; i < count; i++) {
+    CurrentPiece_t piece = placement_piece(gen, i);
+    if (same_piece(&piece, &target)) {
+      ai->length = placement_path(gen, i, ai->path, AI_PATH_MAX);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Возвращает очередное действие автоигрока.
+ *
+ * Заменяет ввод с клавиатуры: вызывающий применяет действие
+ * (apply_user_action) и вызывает функцию снова, пока она не вернет
+ * ActionNone — это значит, что до следующего тика делать нечего. Путь
+ * планируется один раз на фигуру (ai_search). Если фигура оказалась не
+ * там, где ожидалось (вмешался игрок или гравитация сдвинула ее на
+ * несколько строк), путь строится заново из нынешнего положения.
+ * @param ai Автоигрок.
+ * @param game Игра.
+ * @return UserAction_t Действие или ActionNone.
+ */
+UserAction_t ai_next_action(AiPlayer_t *ai, const GameData_t *game) {
+  if (game->state == Start) return ActionStart;
+  if (game->state != Moving || game->info.pause) return ActionNone;
+
+  const CurrentPiece_t *piece = &game->current_piece;
+  if (ai->planned && ai->piece_count == game->piece_count &&
+      !same_piece(piece, &ai->expected)) {
+    // Ожидаемый шаг гравитации: фигура опустилась ровно на строку
+    CurrentPiece_t fallen = ai->expected;
+    fallen.y++;
+    if (ai->step < ai->length && ai->path[ai->step] == ActionNone &&
+        same_piece(piece, &fallen)) {
+      ai->expected = fallen;
+      ai->step++;
+    } else {
+      ai->planned = false;
+    }
+  }
+  if (!ai->planned || ai->piece_count != game->piece_count) {
+    plan_move(ai, game);
+  }
+  if (ai->step >= ai->length || ai->path[ai->step] == ActionNone) {
+    return ActionNone;
+  }
+
+  UserAction_t action = ai->path[ai->step++];
+  GameData_t copy = *game;
+  apply_user_action(&copy, action);
+  ai->expected = copy.current_piece;
+  return action;
+}
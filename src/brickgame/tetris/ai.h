@@ -0,0 +1,85 @@
+#ifndef BRICKGAME_TETRIS_AI_H
+#define BRICKGAME_TETRIS_AI_H
+
+#include "brickgame/tetris/movegen.h"
+#include "brickgame/tetris/undo.h"
+
+#define AI_BEAM_MAX 64
+#define AI_DEPTH_MAX (PREVIEW_MAX + 1)
+#define AI_DEFAULT_WIDTH 16
+#define AI_DEFAULT_DEPTH 3
+#define AI_PATH_MAX MOVEGEN_MAX_STATES
+
+typedef struct {
+  int height;
+  int holes;
+  int bumpiness;
+} AiFeatures_t;
+
+typedef struct {
+  int64_t height;
+  int64_t lines;
+  int64_t holes;
+  int64_t bumpiness;
+} AiWeights_t;
+
+typedef struct {
+  GameData_t game;
+  CurrentPiece_t first;
+  int64_t value;
+  int lines;
+} AiNode_t;
+
+typedef struct {
+  CurrentPiece_t piece;
+  uint64_t hash;
+  int64_t value;
+  int lines;
+  int parent;
+  int order;
+} AiChild_t;
+
+typedef void (*AiTaskFn_t)(void *context, int worker, int64_t task);
+typedef void (*AiParallelFn_t)(void *runner, int threads, int64_t task_count,
+                               AiTaskFn_t fn, void *context);
+
+typedef struct {
+  AiWeights_t weights;
+  int width;
+  int depth;
+  int threads;
+  AiParallelFn_t parallel;
+  void *runner;
+
+  int ply;
+  int piece;
+  int beam_count;
+  AiNode_t *beam;
+  AiNode_t *next;
+  AiChild_t *children;
+  AiChild_t *ranked;
+  int *child_counts;
+  MoveGen_t *gens;
+  UndoStack_t *stacks;
+
+  long piece_count;
+  bool planned;
+  CurrentPiece_t expected;
+  UserAction_t path[AI_PATH_MAX];
+  int length;
+  int step;
+  long plans;
+  long nodes;
+} AiPlayer_t;
+
+extern const AiWeights_t AI_DEFAULT_WEIGHTS;
+
+AiPlayer_t *ai_create(int width, int depth, int threads);
+void ai_destroy(AiPlayer_t *ai);
+void ai_features(const GameData_t *game, AiFeatures_t *features);
+int64_t ai_evaluate(const GameData_t *game, const AiWeights_t *weights,
+                    int lines);
+bool ai_search(AiPlayer_t *ai, const GameData_t *game, CurrentPiece_t *best);
+UserAction_t ai_next_action(AiPlayer_t *ai, const GameData_t *game);
+
+#endif
@@ -0,0 +1,652 @@
+#include "brickgame/tetris/batch.h"
+
+#include <pthread.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define BATCH_HAS_X86 1
+#else
+#define BATCH_HAS_X86 0
+#endif
+
+#define BATCH_MASK_MIN_X (PIECE_MIN_X - 1)
+#define BATCH_MASK_SLOTS (PIECE_X_SLOTS + 2)
+
+static uint64_t BATCH_MASKS[PIECE_COUNT][ROTATION_COUNT][BATCH_MASK_SLOTS];
+static pthread_once_t batch_masks_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Строит упакованные 64-битные маски фигур для пакетного движка.
+ *
+ * Четыре строки фигуры укладываются в одно 64-битное слово в том же
+ * порядке, в каком лежат четыре соседние строки доски в памяти, поэтому
+ * коллизия проверяется одной операцией AND. Для x за пределами таблицы
+ * поворотов хранится маска из одних единиц — она всегда дает коллизию.
+ */
+static void build_batch_masks(void) {
+  init_piece_tables();
+  for (int piece = 0; piece < PIECE_COUNT; piece++) {
+    for (int r = 0; r < ROTATION_COUNT; r++) {
+      const PieceRotation_t *rotation = &PIECE_ROTATIONS[piece][r];
+      for (int slot = 0; slot < BATCH_MASK_SLOTS; slot++) {
+        int x = slot + BATCH_MASK_MIN_X;
+        uint64_t mask = ~0ULL;
+        if (x >= PIECE_MIN_X && x < BOARD_WIDTH) {
+          uint16_t rows[4];
+          for (int i = 0; i < 4; i++) {
+            rows[i] = (uint16_t)(rotation->rows[i] << (x + BATCH_LEFT_PAD));
+          }
+          memcpy(&mask, rows, sizeof(mask));
+        }
+        BATCH_MASKS[piece][r][slot] = mask;
+      }
+    }
+  }
+}
+
+static inline uint64_t load_rows64(const uint16_t *rows) {
+  uint64_t value;
+  memcpy(&value, rows, sizeof(value));
+  return value;
+}
+
+static inline size_t lane_row(int lane, int y) {
+  return (size_t)lane * BATCH_ROW_STRIDE + BATCH_TOP_PAD + y;
+}
+
+static inline int lane_mask_index(const GameBatch_t *batch, int lane) {
+  int x = batch->cand_x[lane];
+  if (x < BATCH_MASK_MIN_X) x = BATCH_MASK_MIN_X;
+  if (x > BATCH_MASK_MIN_X + BATCH_MASK_SLOTS - 1)
+    x = BATCH_MASK_MIN_X + BATCH_MASK_SLOTS - 1;
+  return (batch->piece[lane] * ROTATION_COUNT + batch->cand_rotation[lane]) *
+             BATCH_MASK_SLOTS +
+         x - BATCH_MASK_MIN_X;
+}
+
+static inline bool lane_collides(const GameBatch_t *batch, int lane) {
+  const uint64_t *masks = &BATCH_MASKS[0][0][0];
+  uint64_t board =
+      load_rows64(batch->rows + lane_row(lane, batch->cand_y[lane]));
+  return (board & masks[lane_mask_index(batch, lane)]) != 0;
+}
+
+static void collide_scalar(const GameBatch_t *batch, const int32_t *lanes,
+                           int n) {
+  for (int k = 0; k < n; k++) {
+    batch->hit[lanes[k]] = lane_collides(batch, lanes[k]);
+  }
+}
+
+static uint32_t full_rows_scalar(const GameBatch_t *batch, int lane) {
+  const uint16_t *rows = batch->rows + lane_row(lane, 0);
+  uint32_t full = 0;
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    if (rows[y] == BATCH_FULL_ROW) full |= 1u << y;
+  }
+  return full;
+}
+
+#if BATCH_HAS_X86
+static void collide_sse2(const GameBatch_t *batch, const int32_t *lanes,
+                         int n) {
+  const uint64_t *masks = &BATCH_MASKS[0][0][0];
+  int k = 0;
+  for (; k + 2 <= n; k += 2) {
+    int a = lanes[k], b = lanes[k + 1];
+    __m128i board = _mm_set_epi64x(
+        (long long)load_rows64(batch->rows + lane_row(b, batch->cand_y[b])),
+        (long long)load_rows64(batch->rows + lane_row(a, batch->cand_y[a])));
+    __m128i mask = _mm_set_epi64x((long long)masks[lane_mask_index(batch, b)],
+                                  (long long)masks[lane_mask_index(batch, a)]);
+    __m128i empty = _mm_cmpeq_epi32(_mm_and_si128(board, mask),
+                                    _mm_setzero_si128());
+    int bits = _mm_movemask_ps(_mm_castsi128_ps(empty));
+    batch->hit[a] = (bits & 0x3) != 0x3;
+    batch->hit[b] = (bits & 0xC) != 0xC;
+  }
+  collide_scalar(batch, lanes + k, n - k);
+}
+
+static uint32_t full_rows_sse2(const GameBatch_t *batch, int lane) {
+  const uint16_t *rows = batch->rows + lane_row(lane, 0);
+  const __m128i ones = _mm_set1_epi16(-1);
+  __m128i r0 = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *)rows), ones);
+  __m128i r1 =
+      _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *)(rows + 8)), ones);
+  __m128i r2 =
+      _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *)(rows + 16)), ones);
+  uint32_t low = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(r0, r1));
+  uint32_t high = (uint32_t)_mm_movemask_epi8(
+                      _mm_packs_epi16(r2, _mm_setzero_si128())) &
+                  0xFu;
+  return low | high << 16;
+}
+
+__attribute__((target("avx2"))) static void collide_avx2(
+    const GameBatch_t *batch, const int32_t *lanes, int n) {
+  const long long *base = (const long long *)(const void *)batch->rows;
+  const long long *masks = (const long long *)(const void *)BATCH_MASKS;
+  int k = 0;
+  for (; k + 4 <= n; k += 4) {
+    long long offsets[4], indices[4];
+    for (int j = 0; j < 4; j++) {
+      int lane = lanes[k + j];
+      offsets[j] = (long long)(lane_row(lane, batch->cand_y[lane]) *
+                               sizeof(uint16_t));
+      indices[j] = lane_mask_index(batch, lane);
+    }
+    __m256i board = _mm256_i64gather_epi64(
+        base, _mm256_loadu_si256((const __m256i *)offsets), 1);
+    __m256i mask = _mm256_i64gather_epi64(
+        masks, _mm256_loadu_si256((const __m256i *)indices), 8);
+    __m256i empty = _mm256_cmpeq_epi64(_mm256_and_si256(board, mask),
+                                       _mm256_setzero_si256());
+    int bits = _mm256_movemask_pd(_mm256_castsi256_pd(empty));
+    for (int j = 0; j < 4; j++) {
+      batch->hit[lanes[k + j]] = !((bits >> j) & 1);
+    }
+  }
+  collide_sse2(batch, lanes + k, n - k);
+}
+
+__attribute__((target("avx2"))) static uint32_t full_rows_avx2(
+    const GameBatch_t *batch, int lane) {
+  const uint16_t *rows = batch->rows + lane_row(lane, 0);
+  __m256i r0 = _mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i *)rows),
+                                  _mm256_set1_epi16(-1));
+  uint32_t bits = (uint32_t)_mm256_movemask_epi8(
+      _mm256_packs_epi16(r0, _mm256_setzero_si256()));
+  uint32_t low = (bits & 0xFFu) | ((bits >> 8) & 0xFF00u);
+  __m128i r1 = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *)(rows + 16)),
+                               _mm_set1_epi16(-1));
+  uint32_t high = (uint32_t)_mm_movemask_epi8(
+                      _mm_packs_epi16(r1, _mm_setzero_si128())) &
+                  0xFu;
+  return low | high << 16;
+}
+#endif
+
+/**
+ * @brief Выбирает реализацию векторных ядер.
+ *
+ * @param batch Указатель на пакет игр.
+ * @param kernel Желаемое ядро (BatchKernelAuto — лучшее доступное).
+ * @return BatchKernel_t Фактически выбранное ядро: если запрошенный набор
+ * инструкций недоступен, выбирается ближайший более простой.
+ */
+BatchKernel_t batch_set_kernel(GameBatch_t *batch, BatchKernel_t kernel) {
+#if BATCH_HAS_X86
+  bool has_avx2 = __builtin_cpu_supports("avx2");
+  if (kernel == BatchKernelAuto)
+    kernel = has_avx2 ? BatchKernelAVX2 : BatchKernelSSE2;
+  if (kernel == BatchKernelAVX2 && !has_avx2) kernel = BatchKernelSSE2;
+#else
+  kernel = BatchKernelScalar;
+#endif
+  batch->kernel = kernel;
+  return kernel;
+}
+
+/**
+ * @brief Проверяет коллизии кандидатов для списка игр пакета.
+ *
+ * Для каждой игры из списка берется позиция-кандидат (`cand_x`, `cand_y`,
+ * `cand_rotation`), результат записывается в `hit[lane]`.
+ * @param batch Указатель на пакет игр.
+ * @param lanes Индексы проверяемых игр.
+ * @param n Количество индексов.
+ */
+void batch_check_collisions(const GameBatch_t *batch, const int32_t *lanes,
+                            int n) {
+#if BATCH_HAS_X86
+  if (batch->kernel == BatchKernelAVX2) {
+    collide_avx2(batch, lanes, n);
+    return;
+  }
+  if (batch->kernel == BatchKernelSSE2) {
+    collide_sse2(batch, lanes, n);
+    return;
+  }
+#endif
+  collide_scalar(batch, lanes, n);
+}
+
+/**
+ * @brief Возвращает маску заполненных строк игрового поля одной игры.
+ *
+ * @param batch Указатель на пакет игр.
+ * @param lane Индекс игры.
+ * @return uint32_t Бит y установлен, если строка y заполнена.
+ */
+uint32_t batch_full_rows(const GameBatch_t *batch, int lane) {
+#if BATCH_HAS_X86
+  if (batch->kernel == BatchKernelAVX2) return full_rows_avx2(batch, lane);
+  if (batch->kernel == BatchKernelSSE2) return full_rows_sse2(batch, lane);
+#endif
+  return full_rows_scalar(batch, lane);
+}
+
+/**
+ * @brief Создает пакет из count игр в раскладке "структура массивов".
+ *
+ * Каждое поле игры хранится в отдельном непрерывном массиве. Строки доски
+ * каждой игры занимают BATCH_ROW_STRIDE слов: сверху BATCH_TOP_PAD строк
+ * с одними стенами, затем BOARD_HEIGHT строк поля, затем строки "пола".
+ * Столбец x хранится в бите x + BATCH_LEFT_PAD, остальные биты — стены.
+ * @param count Количество игр в пакете.
+ * @return GameBatch_t* Новый пакет (состояние — как после batch_reset с
+ * рекордом 0 и начальным значением 0) или NULL при ошибке выделения памяти.
+ */
+GameBatch_t *batch_create(int count) {
+  if (count <= 0) return NULL;
+  pthread_once(&batch_masks_once, build_batch_masks);
+
+  GameBatch_t *batch = calloc(1, sizeof(GameBatch_t));
+  if (batch == NULL) return NULL;
+
+  size_t n = (size_t)count;
+  batch->count = count;
+  batch->rows = aligned_alloc(64, n * BATCH_ROW_STRIDE * sizeof(uint16_t));
+  batch->colors = calloc(n * BOARD_HEIGHT * BOARD_WIDTH, sizeof(uint8_t));
+  batch->state = calloc(n, sizeof(uint8_t));
+  batch->pause = calloc(n, sizeof(uint8_t));
+  batch->piece = calloc(n, sizeof(int8_t));
+  batch->rotation = calloc(n, sizeof(int8_t));
+  batch->x = calloc(n, sizeof(int8_t));
+  batch->y = calloc(n, sizeof(int8_t));
+  batch->next_piece = calloc(n, sizeof(int8_t));
+  batch->color_index = calloc(n, sizeof(uint8_t));
+  batch->generator = calloc(n, sizeof(PieceGenerator_t));
+  batch->tick = calloc(n, sizeof(int32_t));
+  batch->next_shift = calloc(n, sizeof(int32_t));
+  batch->piece_count = calloc(n, sizeof(int32_t));
+  batch->score = calloc(n, sizeof(int32_t));
+  batch->high_score = calloc(n, sizeof(int32_t));
+  batch->level = calloc(n, sizeof(int32_t));
+  batch->lanes = calloc(3 * n, sizeof(int32_t));
+  batch->cand_x = calloc(n, sizeof(int8_t));
+  batch->cand_y = calloc(n, sizeof(int8_t));
+  batch->cand_rotation = calloc(n, sizeof(int8_t));
+  batch->hit = calloc(n, sizeof(uint8_t));
+
+  if (!batch->rows || !batch->colors || !batch->state || !batch->pause ||
+      !batch->piece || !batch->rotation || !batch->x || !batch->y ||
+      !batch->next_piece || !batch->color_index || !batch->generator ||
+      !batch->tick || !batch->next_shift || !batch->piece_count ||
+      !batch->score || !batch->high_score || !batch->level || !batch->lanes ||
+      !batch->cand_x || !batch->cand_y || !batch->cand_rotation ||
+      !batch->hit) {
+    batch_destroy(batch);
+    return NULL;
+  }
+
+  batch_set_kernel(batch, BatchKernelAuto);
+  batch_reset(batch, 0, 0);
+  return batch;
+}
+
+/**
+ * @brief Освобождает пакет игр.
+ *
+ * @param batch Указатель на пакет игр (NULL допускается).
+ */
+void batch_destroy(GameBatch_t *batch) {
+  if (batch == NULL) return;
+  free(batch->rows);
+  free(batch->colors);
+  free(batch->state);
+  free(batch->pause);
+  free(batch->piece);
+  free(batch->rotation);
+  free(batch->x);
+  free(batch->y);
+  free(batch->next_piece);
+  free(batch->color_index);
+  free(batch->generator);
+  free(batch->tick);
+  free(batch->next_shift);
+  free(batch->piece_count);
+  free(batch->score);
+  free(batch->high_score);
+  free(batch->level);
+  free(batch->lanes);
+  free(batch->cand_x);
+  free(batch->cand_y);
+  free(batch->cand_rotation);
+  free(batch->hit);
+  free(batch);
+}
+
+static void reset_lane_rows(GameBatch_t *batch, int lane) {
+  uint16_t *rows = batch->rows + (size_t)lane * BATCH_ROW_STRIDE;
+  for (int y = 0; y < BATCH_ROW_STRIDE; y++) {
+    rows[y] = y < BATCH_TOP_PAD + BOARD_HEIGHT ? BATCH_WALL_ROW
+                                               : BATCH_FULL_ROW;
+  }
+}
+
+/**
+ * @brief Переводит все игры пакета в начальное состояние.
+ *
+ * Аналог initialize_game_core для каждой игры пакета. У каждой игры свой
+ * генератор фигур: игра с индексом lane засевается значением seed + lane.
+ * @param batch Указатель на пакет игр.
+ * @param high_score Рекорд, с которым начинается каждая игра.
+ * @param seed Начальное значение генератора фигур для игры с индексом 0.
+ */
+void batch_reset(GameBatch_t *batch, int high_score, uint64_t seed) {
+  batch->speed_threshold = 20;
+  memset(batch->colors, 0,
+         (size_t)batch->count * BOARD_HEIGHT * BOARD_WIDTH * sizeof(uint8_t));
+  for (int lane = 0; lane < batch->count; lane++) {
+    reset_lane_rows(batch, lane);
+    batch->state[lane] = Start;
+    batch->pause[lane] = false;
+    batch->piece[lane] = 0;
+    batch->rotation[lane] = 0;
+    batch->x[lane] = 0;
+    batch->y[lane] = 0;
+    batch->color_index[lane] = 0;
+    piece_generator_seed(&batch->generator[lane], seed + (uint64_t)lane,
+                         RandomizerUniform);
+    batch->next_piece[lane] =
+        (int8_t)piece_generator_next(&batch->generator[lane]);
+    batch->tick[lane] = 0;
+    batch->next_shift[lane] = 0;
+    batch->piece_count[lane] = 0;
+    batch->score[lane] = 0;
+    batch->high_score[lane] = high_score;
+    batch->level[lane] = 1;
+  }
+}
+
+static inline void set_candidate(GameBatch_t *batch, int lane) {
+  batch->cand_x[lane] = batch->x[lane];
+  batch->cand_y[lane] = batch->y[lane];
+  batch->cand_rotation[lane] = batch->rotation[lane];
+}
+
+static inline void commit_candidate(GameBatch_t *batch, int lane) {
+  batch->x[lane] = batch->cand_x[lane];
+  batch->y[lane] = batch->cand_y[lane];
+  batch->rotation[lane] = batch->cand_rotation[lane];
+}
+
+static inline uint8_t *lane_colors(GameBatch_t *batch, int lane, int y) {
+  return batch->colors + ((size_t)lane * BOARD_HEIGHT + y) * BOARD_WIDTH;
+}
+
+static void imprint_lane(GameBatch_t *batch, int lane) {
+  const PieceRotation_t *rotation =
+      &PIECE_ROTATIONS[batch->piece[lane]][batch->rotation[lane]];
+  for (int i = 0; i < 4; i++) {
+    int board_y = batch->y[lane] + i;
+    if (board_y < 0 || board_y >= BOARD_HEIGHT || !rotation->rows[i]) continue;
+    for (int j = 0; j < 4; j++) {
+      if (!(rotation->rows[i] & (1u << j))) continue;
+      int board_x = batch->x[lane] + j;
+      batch->rows[lane_row(lane, board_y)] |=
+          (uint16_t)(1u << (board_x + BATCH_LEFT_PAD));
+      lane_colors(batch, lane, board_y)[board_x] = batch->color_index[lane];
+    }
+  }
+}
+
+static int compact_lane(GameBatch_t *batch, int lane, uint32_t full) {
+  uint16_t *rows = batch->rows + lane_row(lane, 0);
+  int cleared = 0;
+  int write = BOARD_HEIGHT - 1;
+  for (int read = BOARD_HEIGHT - 1; read >= 0; read--) {
+    if ((full >> read) & 1u) {
+      cleared++;
+      continue;
+    }
+    if (write != read) {
+      rows[write] = rows[read];
+      memcpy(lane_colors(batch, lane, write), lane_colors(batch, lane, read),
+             BOARD_WIDTH);
+    }
+    write--;
+  }
+  for (; write >= 0; write--) {
+    rows[write] = BATCH_WALL_ROW;
+    memset(lane_colors(batch, lane, write), 0, BOARD_WIDTH);
+  }
+  return cleared;
+}
+
+static void apply_actions(GameBatch_t *batch, const UserAction_t *actions) {
+  int32_t *moves = batch->lanes;
+  int32_t *drops = batch->lanes + batch->count;
+  int move_count = 0, drop_count = 0;
+
+  for (int lane = 0; lane < batch->count; lane++) {
+    UserAction_t action = actions ? actions[lane] : ActionNone;
+    if (action == ActionTerminate) {
+      batch->state[lane] = GameOver;
+      continue;
+    }
+    if (action == ActionPause) {
+      if (batch->state[lane] != Start && batch->state[lane] != GameOver)
+        batch->pause[lane] = !batch->pause[lane];
+      continue;
+    }
+    if (batch->pause[lane]) continue;
+    if (batch->state[lane] == Start && action == ActionStart) {
+      batch->state[lane] = Spawn;
+      continue;
+    }
+    if (batch->state[lane] != Moving) continue;
+
+    set_candidate(batch, lane);
+    if (action == ActionMoveLeft)
+      batch->cand_x[lane]--;
+    else if (action == ActionMoveRight)
+      batch->cand_x[lane]++;
+    else if (action == ActionRotate)
+      batch->cand_rotation[lane] =
+          (int8_t)((batch->rotation[lane] + 1) % ROTATION_COUNT);
+    else if (action == ActionMoveDown) {
+      drops[drop_count++] = lane;
+      continue;
+    } else {
+      continue;
+    }
+    moves[move_count++] = lane;
+  }
+
+  batch_check_collisions(batch, moves, move_count);
+  for (int k = 0; k < move_count; k++) {
+    if (!batch->hit[moves[k]]) commit_candidate(batch, moves[k]);
+  }
+
+  // Жесткое падение: все падающие фигуры опускаются на строку за проход
+  while (drop_count > 0) {
+    batch_check_collisions(batch, drops, drop_count);
+    int still_falling = 0;
+    for (int k = 0; k < drop_count; k++) {
+      int lane = drops[k];
+      if (batch->hit[lane]) {
+        batch->y[lane] = (int8_t)(batch->cand_y[lane] - 1);
+        batch->state[lane] = Attaching;
+      } else {
+        batch->cand_y[lane]++;
+        drops[still_falling++] = lane;
+      }
+    }
+    drop_count = still_falling;
+  }
+}
+
+static inline int32_t lane_gravity_interval(const GameBatch_t *batch,
+                                            int lane) {
+  int32_t interval = batch->speed_threshold - batch->level[lane] + 1;
+  return interval > 0 ? interval : 1;
+}
+
+static void run_transitions(GameBatch_t *batch) {
+  int32_t *spawns = batch->lanes;
+  int32_t *shifts = batch->lanes + batch->count;
+  int32_t *attaches = batch->lanes + 2 * batch->count;
+  int spawn_count = 0, shift_count = 0, attach_count = 0;
+
+  for (int lane = 0; lane < batch->count; lane++) {
+    if (batch->pause[lane]) continue;
+    int32_t now = batch->tick[lane]++;
+    if (batch->state[lane] == Moving && now >= batch->next_shift[lane]) {
+      batch->state[lane] = Shifting;
+      batch->next_shift[lane] = now + lane_gravity_interval(batch, lane);
+    }
+    if (batch->state[lane] == Spawn)
+      spawns[spawn_count++] = lane;
+    else if (batch->state[lane] == Shifting)
+      shifts[shift_count++] = lane;
+    else if (batch->state[lane] == Attaching)
+      attaches[attach_count++] = lane;
+  }
+
+  for (int k = 0; k < spawn_count; k++) {
+    int lane = spawns[k];
+    batch->piece[lane] = batch->next_piece[lane];
+    batch->rotation[lane] = 0;
+    batch->x[lane] = SPAWN_X;
+    batch->y[lane] = SPAWN_Y;
+    batch->color_index[lane] = (uint8_t)(batch->next_piece[lane] + 1);
+    batch->next_piece[lane] =
+        (int8_t)piece_generator_next(&batch->generator[lane]);
+    set_candidate(batch, lane);
+  }
+  batch_check_collisions(batch, spawns, spawn_count);
+  for (int k = 0; k < spawn_count; k++) {
+    int lane = spawns[k];
+    if (batch->hit[lane]) {
+      batch->state[lane] = GameOver;
+      continue;
+    }
+    batch->state[lane] = Moving;
+    batch->next_shift[lane] =
+        batch->tick[lane] - 1 + lane_gravity_interval(batch, lane);
+    batch->piece_count[lane]++;
+  }
+
+  for (int k = 0; k < shift_count; k++) {
+    set_candidate(batch, shifts[k]);
+    batch->cand_y[shifts[k]]++;
+  }
+  batch_check_collisions(batch, shifts, shift_count);
+  for (int k = 0; k < shift_count; k++) {
+    int lane = shifts[k];
+    if (batch->hit[lane]) {
+      batch->state[lane] = Attaching;
+    } else {
+      commit_candidate(batch, lane);
+      batch->state[lane] = Moving;
+    }
+  }
+
+  for (int k = 0; k < attach_count; k++) {
+    int lane = attaches[k];
+    imprint_lane(batch, lane);
+    uint32_t full = batch_full_rows(batch, lane);
+    if (full) {
+      GameInfo_t info = {batch->score[lane], batch->high_score[lane],
+                         batch->level[lane], 0, false};
+      add_score(&info, compact_lane(batch, lane, full));
+      update_level(&info);
+      batch->score[lane] = info.score;
+      batch->high_score[lane] = info.high_score;
+      batch->level[lane] = info.level;
+    }
+    batch->state[lane] = Spawn;
+  }
+}
+
+/**
+ * @brief Выполняет один шаг для всех игр пакета.
+ *
+ * Эквивалентно вызову apply_user_action(actions[i]) и затем
+ * update_game_state для каждой игры, но игры обрабатываются фазами:
+ * сначала собираются списки игр с одинаковым переходом, затем коллизии
+ * и очистка линий проверяются векторными ядрами сразу для всего списка.
+ * @param batch Указатель на пакет игр.
+ * @param actions Массив из batch->count действий (NULL — ActionNone для
+ * всех игр).
+ */
+void batch_step(GameBatch_t *batch, const UserAction_t *actions) {
+  apply_actions(batch, actions);
+  run_transitions(batch);
+}
+
+/**
+ * @brief Копирует состояние одной игры пакета в GameData_t.
+ *
+ * Длина предпросмотра у полученной игры равна 1.
+ * @param batch Указатель на пакет игр.
+ * @param lane Индекс игры.
+ * @param game Структура, в которую записывается состояние.
+ */
+void batch_export_game(const GameBatch_t *batch, int lane, GameData_t *game) {
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    game->rows[y] = (uint16_t)((batch->rows[lane_row(lane, y)] >>
+                                BATCH_LEFT_PAD) &
+                               FULL_ROW_MASK);
+    memcpy(game->board[y],
+           batch->colors + ((size_t)lane * BOARD_HEIGHT + y) * BOARD_WIDTH,
+           BOARD_WIDTH);
+  }
+  refresh_board_summary(game);
+  game->board_version = 0;
+  game->next_piece_index = batch->next_piece[lane];
+  game->preview = (PiecePreview_t){{0}, 0, 0, 1};
+  game->info = (GameInfo_t){batch->score[lane], batch->high_score[lane],
+                            batch->level[lane], 0, batch->pause[lane]};
+  game->state = (GameState_t)batch->state[lane];
+  game->current_piece =
+      (CurrentPiece_t){batch->piece[lane], batch->rotation[lane],
+                       batch->x[lane], batch->y[lane],
+                       batch->color_index[lane]};
+  game->timer.tick = batch->tick[lane];
+  game->timer.next_shift_tick = batch->next_shift[lane];
+  game->timer.speed_threshold = batch->speed_threshold;
+  game->auto_shift = (AutoShift_t){DEFAULT_DAS, DEFAULT_ARR, 0, 0};
+  game->generator = batch->generator[lane];
+  game->piece_count = batch->piece_count[lane];
+  game->settle_transitions = false;
+}
+
+/**
+ * @brief Записывает состояние GameData_t в одну игру пакета.
+ *
+ * Порог скорости пакета общий для всех игр и не изменяется. Пакет всегда
+ * выполняет один переход автомата за шаг: флаг settle_transitions
+ * не переносится. Удерживаемый сдвиг (auto_shift) пакет не моделирует.
+ * Очереди предпросмотра у пакета нет: фигуры, уже взятые из генератора в
+ * `game->preview`, потерялись бы, поэтому переносимая игра должна иметь
+ * длину предпросмотра 1 (как после initialize_game_core).
+ * @param batch Указатель на пакет игр.
+ * @param lane Индекс игры.
+ * @param game Исходное состояние игры.
+ */
+void batch_import_game(GameBatch_t *batch, int lane, const GameData_t *game) {
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    batch->rows[lane_row(lane, y)] =
+        (uint16_t)(BATCH_WALL_ROW | game->rows[y] << BATCH_LEFT_PAD);
+    memcpy(lane_colors(batch, lane, y), game->board[y], BOARD_WIDTH);
+  }
+  batch->next_piece[lane] = (int8_t)game->next_piece_index;
+  batch->score[lane] = game->info.score;
+  batch->high_score[lane] = game->info.high_score;
+  batch->level[lane] = game->info.level;
+  batch->pause[lane] = game->info.pause;
+  batch->state[lane] = (uint8_t)game->state;
+  batch->piece[lane] = (int8_t)game->current_piece.piece;
+  batch->rotation[lane] = (int8_t)game->current_piece.rotation;
+  batch->x[lane] = (int8_t)game->current_piece.x;
+  batch->y[lane] = (int8_t)game->current_piece.y;
+  batch->color_index[lane] = (uint8_t)game->current_piece.color_index;
+  batch->tick[lane] = (int32_t)game->timer.tick;
+  batch->next_shift[lane] = (int32_t)game->timer.next_shift_tick;
+  batch->piece_count[lane] = (int32_t)game->piece_count;
+  batch->generator[lane] = game->generator;
+}
@@ -0,0 +1,65 @@
+#ifndef BRICKGAME_TETRIS_BATCH_H
+#define BRICKGAME_TETRIS_BATCH_H
+
+#include "brickgame/tetris/tetris_core.h"
+
+#define BATCH_ROW_STRIDE 32
+#define BATCH_TOP_PAD 4
+#define BATCH_LEFT_PAD 3
+
+#define BATCH_WALL_ROW 0xE007u
+#define BATCH_FULL_ROW 0xFFFFu
+
+typedef enum {
+  BatchKernelAuto,
+  BatchKernelScalar,
+  BatchKernelSSE2,
+  BatchKernelAVX2
+} BatchKernel_t;
+
+typedef struct {
+  int count;
+  int speed_threshold;
+  BatchKernel_t kernel;
+
+  uint16_t *rows;
+  uint8_t *colors;
+
+  uint8_t *state;
+  uint8_t *pause;
+  int8_t *piece;
+  int8_t *rotation;
+  int8_t *x;
+  int8_t *y;
+  int8_t *next_piece;
+  uint8_t *color_index;
+  PieceGenerator_t *generator;
+
+  int32_t *tick;
+  int32_t *next_shift;
+  int32_t *piece_count;
+  int32_t *score;
+  int32_t *high_score;
+  int32_t *level;
+
+  int32_t *lanes;
+  int8_t *cand_x;
+  int8_t *cand_y;
+  int8_t *cand_rotation;
+  uint8_t *hit;
+} GameBatch_t;
+
+GameBatch_t *batch_create(int count);
+void batch_destroy(GameBatch_t *batch);
+void batch_reset(GameBatch_t *batch, int high_score, uint64_t seed);
+void batch_step(GameBatch_t *batch, const UserAction_t *actions);
+
+BatchKernel_t batch_set_kernel(GameBatch_t *batch, BatchKernel_t kernel);
+void batch_check_collisions(const GameBatch_t *batch, const int32_t *lanes,
+                            int n);
+uint32_t batch_full_rows(const GameBatch_t *batch, int lane);
+
+void batch_export_game(const GameBatch_t *batch, int lane, GameData_t *game);
+void batch_import_game(GameBatch_t *batch, int lane, const GameData_t *game);
+
+#endif
@@ -0,0 +1,117 @@
+#include "brickgame/tetris/tetris_core.h"
+
+#define PCG_MULTIPLIER 6364136223846793005ULL
+#define PCG_INCREMENT 1442695040888963407ULL
+
+/**
+ * @brief Засевает генератор PCG32 (XSH RR, 64 бита состояния).
+ *
+ * @param rng Указатель на состояние генератора.
+ * @param seed Начальное значение; одинаковые значения дают одинаковые
+ * последовательности на любой платформе.
+ */
+void rng_seed(Rng_t *rng, uint64_t seed) {
+  rng->state = 0;
+  rng_next(rng);
+  rng->state += seed;
+  rng_next(rng);
+}
+
+/**
+ * @brief Возвращает следующее 32-битное псевдослучайное число.
+ *
+ * Генератор не использует глобального состояния и блокировок, поэтому
+ * игры в разных потоках не мешают друг другу.
+ * @param rng Указатель на состояние генератора.
+ * @return uint32_t Следующее число последовательности.
+ */
+uint32_t rng_next(Rng_t *rng) {
+  uint64_t old = rng->state;
+  rng->state = old * PCG_MULTIPLIER + PCG_INCREMENT;
+  uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+  uint32_t rot = (uint32_t)(old >> 59u);
+  return (xorshifted >> rot) | (xorshifted << ((-rot) & 31u));
+}
+
+/**
+ * @brief Возвращает псевдослучайное число из диапазона [0, bound).
+ *
+ * Использует умножение со сдвигом вместо деления по модулю.
+ * @param rng Указатель на состояние генератора.
+ * @param bound Верхняя граница (не включается), больше нуля.
+ * @return uint32_t Число от 0 до bound - 1.
+ */
+uint32_t rng_below(Rng_t *rng, uint32_t bound) {
+  return (uint32_t)(((uint64_t)rng_next(rng) * bound) >> 32);
+}
+
+/**
+ * @brief Засевает генератор фигур и выбирает способ генерации.
+ *
+ * @param generator Указатель на генератор фигур.
+ * @param seed Начальное значение генератора.
+ * @param mode RandomizerUniform — независимый выбор каждой фигуры,
+ * RandomizerBag7 — выдача перемешанных "мешков" из всех семи фигур.
+ */
+void piece_generator_seed(PieceGenerator_t *generator, uint64_t seed,
+                          Randomizer_t mode) {
+  rng_seed(&generator->rng, seed);
+  generator->mode = mode;
+  generator->bag_pos = PIECE_COUNT;
+}
+
+/**
+ * @brief Заполняет "мешок" всеми семью фигурами в случайном порядке.
+ *
+ * Весь мешок перемешивается за один раз (тасование Фишера-Йетса).
+ * @param generator Указатель на генератор фигур.
+ */
+static void refill_bag(PieceGenerator_t *generator) {
+  for (int i = 0; i < PIECE_COUNT; i++) generator->bag[i] = (uint8_t)i;
+  for (int i = PIECE_COUNT - 1; i > 0; i--) {
+    int j = (int)rng_below(&generator->rng, (uint32_t)i + 1);
+    uint8_t temp = generator->bag[i];
+    generator->bag[i] = generator->bag[j];
+    generator->bag[j] = temp;
+  }
+  generator->bag_pos = 0;
+}
+
+/**
+ * @brief Выдает индекс следующей фигуры из генератора.
+ *
+ * @param generator Указатель на генератор фигур.
+ * @return int Индекс фигуры в массиве FIGURES (число от 0 до 6).
+ */
+int piece_generator_next(PieceGenerator_t *generator) {
+  if (generator->mode == RandomizerUniform) {
+    return (int)rng_below(&generator->rng, PIECE_COUNT);
+  }
+  if (generator->bag_pos >= PIECE_COUNT) refill_bag(generator);
+  return generator->bag[generator->bag_pos++];
+}
+
+/**
+ * @brief Выдает сразу блок следующих фигур генератора.
+ *
+ * В режиме мешков блок — остаток текущего мешка (если мешок пуст, он
+ * заполняется заново, и блок — весь мешок), в равномерном режиме —
+ * PIECE_COUNT фигур. Последовательность фигур та же, что при вызовах
+ * piece_generator_next по одной.
+ * @param generator Указатель на генератор фигур.
+ * @param pieces Буфер не меньше чем на PIECE_COUNT фигур.
+ * @return int Количество выданных фигур (от 1 до PIECE_COUNT).
+ */
+int piece_generator_block(PieceGenerator_t *generator, uint8_t *pieces) {
+  if (generator->mode == RandomizerUniform) {
+    for (int i = 0; i < PIECE_COUNT; i++) {
+      pieces[i] = (uint8_t)rng_below(&generator->rng, PIECE_COUNT);
+    }
+    return PIECE_COUNT;
+  }
+  if (generator->bag_pos >= PIECE_COUNT) refill_bag(generator);
+  int count = PIECE_COUNT - generator->bag_pos;
+  memcpy(pieces, &generator->bag[generator->bag_pos], (size_t)count);
+  generator->bag_pos = PIECE_COUNT;
+  return count;
+}
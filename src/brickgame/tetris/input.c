@@ -0,0 +1,103 @@
+#include "brickgame/tetris/tetris.h"
+
+/**
+ * @brief Преобразует код нажатой клавиши в игровое действие.
+ *
+ * Является "чистой" функцией, которая не меняет состояние игры, а только
+ * сопоставляет код клавиши (например, KEY_UP) с действием перечисления
+ * (например, ActionRotate).
+ * @param key Код клавиши, полученный от ncurses (например, getch()).
+ * @return Соответствующее игровое действие типа UserAction_t.
+ */
+UserAction_t get_user_action(int key) {
+  if (key == ERR) return ActionNone;
+  if (key == 'q' || key == 'Q') return ActionTerminate;
+  if (key == 'p' || key == 'P') return ActionPause;
+  if (key == KEY_ENTER || key == '\n') return ActionStart;
+  if (key == KEY_LEFT) return ActionMoveLeft;
+  if (key == KEY_RIGHT) return ActionMoveRight;
+  if (key == KEY_DOWN) return ActionMoveDown;
+  if (key == KEY_UP) return ActionRotate;
+  return ActionNone;
+}
+
+typedef struct {
+  GameState_t state;
+  bool pause;
+  CurrentPiece_t piece;
+} ActionEffect_t;
+
+/**
+ * @brief Снимает все, что читает и меняет apply_user_action.
+ *
+ * Кроме этих полей apply_user_action зависит только от поля, а поле
+ * действия не меняют, поэтому игры с равными снимками одинаково
+ * отвечают на любые дальнейшие действия.
+ * @param game Указатель на главную структуру данных игры.
+ * @return ActionEffect_t Снимок состояния.
+ */
+static ActionEffect_t action_effect(const GameData_t *game) {
+  return (ActionEffect_t){game->state, game->info.pause, game->current_piece};
+}
+
+static bool same_effect(const ActionEffect_t *a, const ActionEffect_t *b) {
+  return a->state == b->state && a->pause == b->pause &&
+         a->piece.piece == b->piece.piece &&
+         a->piece.rotation == b->piece.rotation && a->piece.x == b->piece.x &&
+         a->piece.y == b->piece.y;
+}
+
+/**
+ * @brief Сворачивает пачку нажатий, накопившихся за один кадр.
+ *
+ * Каждое действие проверяется на копии игры. Действие, которое ничего не
+ * меняет (сдвиг в стену, поворот в блоки, ход после жесткого падения или
+ * выхода), отбрасывается. Если после действия игра возвращается в
+ * состояние, в котором уже была после одного из оставленных действий,
+ * все действия после него взаимно уничтожаются: влево-вправо, четыре
+ * удавшихся поворота, двойная пауза. Других свертков нет, поэтому
+ * применение результата через apply_user_action дает ту же игру, что и
+ * применение исходных нажатий по одному. Состояния запоминаются
+ * отрезками по COALESCE_CHUNK действий; свертка не выходит за отрезок.
+ * @param game Игра, к которой будут применены действия; не меняется.
+ * @param actions Действия в порядке нажатий.
+ * @param count Количество действий.
+ * @param out Массив для результата (не меньше count элементов).
+ * @param stats Счетчики; увеличиваются на число событий, свернутых и
+ * отброшенных действий (NULL — не считать).
+ * @return int Количество действий в out.
+ */
+int coalesce_actions(const GameData_t *game, const UserAction_t *actions,
+                     int count, UserAction_t *out, InputStats_t *stats) {
+  GameData_t copy = *game;
+  ActionEffect_t seen[COALESCE_CHUNK + 1];
+  int length = 0, base = 0, coalesced = 0, dropped = 0;
+  seen[0] = action_effect(&copy);
+  for (int i = 0; i < count; i++) {
+    if (length - base == COALESCE_CHUNK) {
+      seen[0] = seen[COALESCE_CHUNK];
+      base = length;
+    }
+    apply_user_action(&copy, actions[i]);
+    ActionEffect_t effect = action_effect(&copy);
+
+    int k = length;
+    while (k >= base && !same_effect(&seen[k - base], &effect)) k--;
+    if (k == length) {
+      dropped++;
+    } else if (k >= base) {
+      coalesced += length - k + 1;
+      length = k;
+    } else {
+      out[length++] = actions[i];
+      seen[length - base] = effect;
+    }
+  }
+
+  if (stats) {
+    stats->events += count;
+    stats->coalesced += coalesced;
+    stats->dropped += dropped;
+  }
+  return length;
+}
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "brickgame/tetris/movegen.h"
+
+#define MOVEGEN_PAD_TOP (-MOVEGEN_Y_MIN)
+
+/**
+ * @brief Кодирует состояние фигуры (поворот, y, x) в номер узла поиска.
+ *
+ * @param rotation Индекс поворота.
+ * @param y Строка верхнего края матрицы 4x4 фигуры.
+ * @param x Столбец левого края матрицы 4x4 фигуры.
+ * @return uint16_t Номер узла от 0 до MOVEGEN_MAX_STATES - 1.
+ */
+static inline uint16_t encode_node(int rotation, int y, int x) {
+  return (uint16_t)((rotation * MOVEGEN_Y_SLOTS + (y - MOVEGEN_Y_MIN)) *
+                        PIECE_X_SLOTS +
+                    (x - PIECE_MIN_X));
+}
+
+/**
+ * @brief Проверяет, помещается ли фигура на поле в заданной точке.
+ *
+ * Поле в рабочей области дополнено пустыми строками сверху и заполненными
+ * строками снизу, поэтому проверка пола не требует ветвлений: четыре
+ * сдвинутые маски строк фигуры сравниваются с четырьмя строками поля.
+ * @param gen Рабочая область генератора с подготовленным полем.
+ * @param rotation Элемент таблицы поворотов фигуры.
+ * @param x Столбец левого края матрицы 4x4 фигуры.
+ * @param y Строка верхнего края матрицы 4x4 фигуры.
+ * @return true Если фигура не пересекается со стенами, полом и блоками.
+ */
+static inline bool piece_fits(const MoveGen_t *gen,
+                              const PieceRotation_t *rotation, int x, int y) {
+  if (x < rotation->min_x || x > rotation->max_x) return false;
+
+  const uint16_t *mask = rotation->shifted[x - PIECE_MIN_X];
+  const uint16_t *rows = &gen->rows[y + MOVEGEN_PAD_TOP];
+  return !((rows[0] & mask[0]) | (rows[1] & mask[1]) | (rows[2] & mask[2]) |
+           (rows[3] & mask[3]));
+}
+
+/**
+ * @brief Отмечает состояние посещенным и ставит его в очередь поиска.
+ *
+ * @param gen Рабочая область генератора.
+ * @param tail Указатель на конец очереди.
+ * @param from Узел, из которого выполнен ход.
+ * @param action Ход, переводящий фигуру из узла from в новое состояние.
+ * @param rotation Индекс поворота нового состояния.
+ * @param y Строка нового состояния.
+ * @param x Столбец нового состояния.
+ */
+static inline void visit(MoveGen_t *gen, int *tail, uint16_t from,
+                         UserAction_t action, int rotation, int y, int x) {
+  uint16_t bit = (uint16_t)(1u << (x - PIECE_MIN_X));
+  uint16_t *visited = &gen->visited[rotation][y - MOVEGEN_Y_MIN];
+  if (*visited & bit) return;
+
+  *visited |= bit;
+  uint16_t node = encode_node(rotation, y, x);
+  gen->parent[node] = from;
+  gen->action[node] = (uint8_t)action;
+  gen->queue[(*tail)++] = node;
+}
+
+/**
+ * @brief Запоминает конечное положение фигуры, если оно еще не найдено.
+ *
+ * Положения сравниваются по занятым клеткам: у симметричных фигур разные
+ * повороты сводятся к каноническому повороту из таблицы PIECE_ROTATIONS.
+ * @param gen Рабочая область генератора.
+ * @param node Узел поиска, в котором фигура лежит на опоре.
+ * @param rotation Индекс поворота.
+ * @param y Строка верхнего края матрицы 4x4 фигуры.
+ * @param x Столбец левого края матрицы 4x4 фигуры.
+ */
+static inline void record_landing(MoveGen_t *gen, uint16_t node, int rotation,
+                                  int y, int x) {
+  const PieceRotation_t *table = &PIECE_ROTATIONS[gen->piece][rotation];
+  int key_x = x + table->canonical_dx;
+  int key_y = y + table->canonical_dy;
+  uint16_t bit = (uint16_t)(1u << (key_x - PIECE_MIN_X));
+  uint16_t *landed = &gen->landed[table->canonical][key_y - MOVEGEN_Y_MIN];
+  if (*landed & bit) return;
+
+  *landed |= bit;
+  gen->placements[gen->count++] =
+      (Placement_t){(int8_t)x, (int8_t)y, (int8_t)rotation, node};
+}
+
+/**
+ * @brief Находит все конечные положения фигуры, достижимые из start.
+ *
+ * Выполняет поиск в ширину по состояниям (x, y, поворот) с ходами
+ * ActionMoveLeft, ActionMoveRight, ActionRotate и опусканием на одну
+ * строку под действием гравитации. Ходы повторяют правила apply_user_action:
+ * без "отскоков" от стен, ход с коллизией не выполняется. Посещенные
+ * состояния отмечаются в битовом множестве (одно 16-битное слово на
+ * поворот и строку), поэтому поиск не выделяет памяти: все данные лежат
+ * в рабочей области gen, которую можно переиспользовать между вызовами.
+ * Каждое положение выдается один раз и хранит путь кратчайшей длины.
+ * @param gen Рабочая область генератора; результат в gen->placements.
+ * @param game Игра, поле которой используется для проверки коллизий.
+ * @param start Начальное положение фигуры.
+ * @return int Количество найденных положений (0, если фигура в начальном
+ * положении пересекается с полем).
+ */
+int generate_placements(MoveGen_t *gen, const GameData_t *game,
+                        const CurrentPiece_t *start) {
+  init_piece_tables();
+  gen->piece = start->piece;
+  gen->color_index = start->color_index;
+  gen->count = 0;
+
+  memset(gen->rows, 0, sizeof(uint16_t) * MOVEGEN_PAD_TOP);
+  memcpy(&gen->rows[MOVEGEN_PAD_TOP], game->rows, sizeof(game->rows));
+  for (int i = 0; i < MOVEGEN_FLOOR_ROWS; i++) {
+    gen->rows[MOVEGEN_PAD_TOP + BOARD_HEIGHT + i] = 0xFFFF;
+  }
+  memset(gen->visited, 0, sizeof(gen->visited));
+  memset(gen->landed, 0, sizeof(gen->landed));
+
+  const PieceRotation_t *rotations = PIECE_ROTATIONS[start->piece];
+  if (start->y < MOVEGEN_Y_MIN || start->y >= BOARD_HEIGHT ||
+      !piece_fits(gen, &rotations[start->rotation], start->x, start->y)) {
+    return 0;
+  }
+
+  int head = 0, tail = 0;
+  gen->root = encode_node(start->rotation, start->y, start->x);
+  visit(gen, &tail, gen->root, ActionNone, start->rotation, start->y,
+        start->x);
+
+  while (head < tail) {
+    uint16_t node = gen->queue[head++];
+    int x = node % PIECE_X_SLOTS + PIECE_MIN_X;
+    int y = node / PIECE_X_SLOTS % MOVEGEN_Y_SLOTS + MOVEGEN_Y_MIN;
+    int rotation = node / (PIECE_X_SLOTS * MOVEGEN_Y_SLOTS);
+    const PieceRotation_t *table = &rotations[rotation];
+
+    if (piece_fits(gen, table, x - 1, y)) {
+      visit(gen, &tail, node, ActionMoveLeft, rotation, y, x - 1);
+    }
+    if (piece_fits(gen, table, x + 1, y)) {
+      visit(gen, &tail, node, ActionMoveRight, rotation, y, x + 1);
+    }
+    int next = (rotation + 1) % ROTATION_COUNT;
+    if (piece_fits(gen, &rotations[next], x, y)) {
+      visit(gen, &tail, node, ActionRotate, next, y, x);
+    }
+    if (piece_fits(gen, table, x, y + 1)) {
+      visit(gen, &tail, node, ActionNone, rotation, y + 1, x);
+    } else {
+      record_landing(gen, node, rotation, y, x);
+    }
+  }
+  return gen->count;
+}
+
+/**
+ * @brief Находит все конечные положения фигуры из точки ее появления.
+ *
+ * Начальное положение совпадает с тем, что задает spawn_new_piece.
+ * @param gen Рабочая область генератора; результат в gen->placements.
+ * @param game Игра, поле которой используется для проверки коллизий.
+ * @param piece Индекс фигуры в массиве FIGURES.
+ * @return int Количество найденных положений.
+ */
+int generate_spawn_placements(MoveGen_t *gen, const GameData_t *game,
+                              int piece) {
+  CurrentPiece_t start = {piece, 0, SPAWN_X, SPAWN_Y, piece + 1};
+  return generate_placements(gen, game, &start);
+}
+
+/**
+ * @brief Возвращает найденное положение в виде текущей фигуры игры.
+ *
+ * Результат можно присвоить game->current_piece и впечатать в поле
+ * функцией imprint_piece_to_board.
+ * @param gen Рабочая область генератора после generate_placements.
+ * @param index Номер положения от 0 до gen->count - 1.
+ * @return CurrentPiece_t Фигура в конечном положении.
+ */
+CurrentPiece_t placement_piece(const MoveGen_t *gen, int index) {
+  const Placement_t *placement = &gen->placements[index];
+  return (CurrentPiece_t){gen->piece, placement->rotation, placement->x,
+                          placement->y, gen->color_index};
+}
+
+/**
+ * @brief Фиксирует фигуру в найденном положении, как при ее падении.
+ *
+ * Впечатывает фигуру в поле, очищает заполненные линии и начисляет очки.
+ * Генерация следующей фигуры и смена состояния не выполняются.
+ * @param game Игра, поле которой использовалось в generate_placements.
+ * @param gen Рабочая область генератора после generate_placements.
+ * @param index Номер положения от 0 до gen->count - 1.
+ */
+void play_placement(GameData_t *game, const MoveGen_t *gen, int index) {
+  game->current_piece = placement_piece(gen, index);
+  imprint_piece_to_board(game);
+  process_scoring_and_levelup(game);
+}
+
+/**
+ * @brief Восстанавливает последовательность ходов до найденного положения.
+ *
+ * ActionNone в пути означает ожидание одного шага гравитации (фигура
+ * опускается на строку), последний ход всегда ActionMoveDown — фиксация
+ * фигуры. Если буфер меньше пути, записывается только его начало.
+ * @param gen Рабочая область генератора после generate_placements.
+ * @param index Номер положения от 0 до gen->count - 1.
+ * @param path Буфер для ходов.
+ * @param capacity Размер буфера path.
+ * @return int Полная длина пути.
+ */
+int placement_path(const MoveGen_t *gen, int index, UserAction_t *path,
+                   int capacity) {
+  uint16_t last = gen->placements[index].node;
+  int length = 1;
+  for (uint16_t node = last; node != gen->root; node = gen->parent[node]) {
+    length++;
+  }
+
+  int i = length - 1;
+  if (i < capacity) path[i] = ActionMoveDown;
+  for (uint16_t node = last; node != gen->root; node = gen->parent[node]) {
+    i--;
+    if (i < capacity) path[i] = (UserAction_t)gen->action[node];
+  }
+  return length;
+}
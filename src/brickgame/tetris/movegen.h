@@ -0,0 +1,43 @@
+#ifndef BRICKGAME_TETRIS_MOVEGEN_H
+#define BRICKGAME_TETRIS_MOVEGEN_H
+
+#include "brickgame/tetris/tetris_core.h"
+
+#define MOVEGEN_Y_MIN (-6)
+#define MOVEGEN_Y_SLOTS (BOARD_HEIGHT - MOVEGEN_Y_MIN)
+#define MOVEGEN_MAX_STATES (ROTATION_COUNT * MOVEGEN_Y_SLOTS * PIECE_X_SLOTS)
+#define MOVEGEN_FLOOR_ROWS 4
+
+typedef struct {
+  int8_t x;
+  int8_t y;
+  int8_t rotation;
+  uint16_t node;
+} Placement_t;
+
+typedef struct {
+  int piece;
+  int color_index;
+  int count;
+  uint16_t root;
+
+  uint16_t rows[-MOVEGEN_Y_MIN + BOARD_HEIGHT + MOVEGEN_FLOOR_ROWS];
+  uint16_t visited[ROTATION_COUNT][MOVEGEN_Y_SLOTS];
+  uint16_t landed[ROTATION_COUNT][MOVEGEN_Y_SLOTS];
+
+  uint16_t queue[MOVEGEN_MAX_STATES];
+  uint16_t parent[MOVEGEN_MAX_STATES];
+  uint8_t action[MOVEGEN_MAX_STATES];
+  Placement_t placements[MOVEGEN_MAX_STATES];
+} MoveGen_t;
+
+int generate_placements(MoveGen_t *gen, const GameData_t *game,
+                        const CurrentPiece_t *start);
+int generate_spawn_placements(MoveGen_t *gen, const GameData_t *game,
+                              int piece);
+CurrentPiece_t placement_piece(const MoveGen_t *gen, int index);
+void play_placement(GameData_t *game, const MoveGen_t *gen, int index);
+int placement_path(const MoveGen_t *gen, int index, UserAction_t *path,
+                   int capacity);
+
+#endif
@@ -0,0 +1,109 @@
+#include "brickgame/tetris/perft.h"
+
+/**
+ * @brief Выписывает очередь из depth фигур, которые получит игра.
+ *
+ * Сначала идут фигуры предпросмотра (preview_piece), остальные берутся из
+ * копии генератора игры, поэтому сама игра не меняется.
+ * Последовательность фигур не зависит от положения блоков на поле.
+ * @param game Игра, для которой строится очередь.
+ * @param queue Буфер для индексов фигур длиной не меньше depth.
+ * @param depth Количество фигур.
+ */
+void perft_queue(const GameData_t *game, int *queue, int depth) {
+  PieceGenerator_t generator = game->generator;
+  for (int i = 0; i < depth; i++) {
+    int piece = preview_piece(game, i);
+    queue[i] = piece >= 0 ? piece : piece_generator_next(&generator);
+  }
+}
+
+/**
+ * @brief Рекурсивный шаг perft: расставляет фигуру и откатывает ход.
+ *
+ * Если журнал не принимает ход (на корневом поле уже есть заполненные
+ * строки), ветка считается на копии поля. С таблицей транспозиций число
+ * листьев поддерева запоминается по хэшу поля и глубине: очередь фигур
+ * зависит только от глубины, поэтому поле, полученное другим порядком
+ * расстановок, дает то же поддерево.
+ * @param gens Рабочие области генератора ходов, по одной на уровень.
+ * @param stack Стек отмены.
+ * @param table Таблица транспозиций или NULL.
+ * @param game Поле узла; после возврата совпадает с исходным.
+ * @param queue Очередь фигур.
+ * @param depth Оставшаяся глубина, не меньше 1.
+ * @return uint64_t Количество листьев.
+ */
+static uint64_t perft_node(MoveGen_t *gens, UndoStack_t *stack,
+                           TTable_t *table, GameData_t *game,
+                           const int *queue, int depth) {
+  uint64_t key = 0;
+  int64_t cached;
+  if (table) {
+    key = ttable_key(game->hash, queue[0],
+                     depth > 1 ? queue[1] : TTABLE_NO_PIECE, depth);
+    if (ttable_probe(table, key, &cached)) return (uint64_t)cached;
+  }
+
+  int count = generate_spawn_placements(gens, game, queue[0]);
+  uint64_t nodes = 0;
+  if (depth == 1) nodes = (uint64_t)count;
+  for (int i = 0; depth > 1 && i < count; i++) {
+    if (undo_place_piece(stack, game, placement_piece(gens, i))) {
+      nodes += perft_node(gens + 1, stack, table, game, queue + 1, depth - 1);
+      undo_restore(stack, game);
+    } else {
+      GameData_t child = *game;
+      play_placement(&child, gens, i);
+      nodes +=
+          perft_node(gens + 1, stack, table, &child, queue + 1, depth - 1);
+    }
+  }
+  if (table) ttable_store(table, key, (int64_t)nodes);
+  return nodes;
+}
+
+/**
+ * @brief Считает листья дерева всех расстановок следующих depth фигур.
+ *
+ * Каждый узел дерева — поле после фиксации очередной фигуры в одном из
+ * положений, найденных generate_spawn_placements (с очисткой линий).
+ * Ветка, в которой фигуре некуда появиться, листьев не дает. На последнем
+ * уровне листья не строятся, а считаются по числу найденных положений.
+ * Поле копируется один раз: дальше ходы делаются и отменяются через
+ * журнал отмены (undo_place_piece), без копирования GameData_t на узел.
+ * @param gens Рабочие области генератора ходов, по одной на уровень
+ * (не меньше depth штук).
+ * @param game Корневое поле.
+ * @param queue Очередь фигур длиной не меньше depth.
+ * @param depth Глубина дерева, не больше PERFT_MAX_DEPTH.
+ * @return uint64_t Количество листьев на глубине depth.
+ */
+uint64_t perft(MoveGen_t *gens, const GameData_t *game, const int *queue,
+               int depth) {
+  return perft_cached(gens, NULL, game, queue, depth);
+}
+
+/**
+ * @brief То же, что perft, но с таблицей транспозиций.
+ *
+ * Поддеревья одинаковых полей на одной глубине считаются один раз.
+ * Результат совпадает с perft, пока в таблице нет коллизий 64-битных
+ * ключей. Таблицу можно переиспользовать между вызовами с одной и той
+ * же очередью фигур; для другой очереди ее нужно очистить (ttable_clear).
+ * @param gens Рабочие области генератора ходов, по одной на уровень.
+ * @param table Таблица транспозиций или NULL (тогда это perft).
+ * @param game Корневое поле.
+ * @param queue Очередь фигур длиной не меньше depth.
+ * @param depth Глубина дерева, не больше PERFT_MAX_DEPTH.
+ * @return uint64_t Количество листьев на глубине depth.
+ */
+uint64_t perft_cached(MoveGen_t *gens, TTable_t *table, const GameData_t *game,
+                      const int *queue, int depth) {
+  if (depth <= 0) return 1;
+
+  GameData_t work = *game;
+  UndoStack_t stack;
+  undo_reset(&stack);
+  return perft_node(gens, &stack, table, &work, queue, depth);
+}
@@ -0,0 +1,16 @@
+#ifndef BRICKGAME_TETRIS_PERFT_H
+#define BRICKGAME_TETRIS_PERFT_H
+
+#include "brickgame/tetris/movegen.h"
+#include "brickgame/tetris/ttable.h"
+#include "brickgame/tetris/undo.h"
+
+#define PERFT_MAX_DEPTH 16
+
+void perft_queue(const GameData_t *game, int *queue, int depth);
+uint64_t perft(MoveGen_t *gens, const GameData_t *game, const int *queue,
+               int depth);
+uint64_t perft_cached(MoveGen_t *gens, TTable_t *table, const GameData_t *game,
+                      const int *queue, int depth);
+
+#endif
@@ -0,0 +1,322 @@
+#include "brickgame/tetris/recorder.h"
+
+/**
+ * @brief Записывает беззнаковое число в формате varint (LEB128).
+ *
+ * Числа меньше 128 занимают один байт, поэтому события, идущие чаще
+ * одного раза в 16 тиков, кодируются одним байтом.
+ * @param file Файл для записи.
+ * @param value Записываемое число.
+ * @return true Если запись прошла успешно.
+ */
+static bool write_varint(FILE *file, uint64_t value) {
+  uint8_t buffer[10];
+  int length = 0;
+  do {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    buffer[length++] = value ? (uint8_t)(byte | 0x80) : byte;
+  } while (value);
+  return fwrite(buffer, 1, (size_t)length, file) == (size_t)length;
+}
+
+/**
+ * @brief Читает беззнаковое число в формате varint (LEB128).
+ *
+ * @param file Файл для чтения.
+ * @param value Указатель для прочитанного числа.
+ * @return true Если число прочитано целиком.
+ */
+static bool read_varint(FILE *file, uint64_t *value) {
+  *value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    int byte = fgetc(file);
+    if (byte == EOF) return false;
+    *value |= (uint64_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Создает файл записи и пишет в него заголовок.
+ *
+ * Заголовок: сигнатура REPLAY_MAGIC, версия, флаги, начальное значение
+ * генератора (8 байт, little-endian) и рекорд на момент начала игры. С
+ * флагом REPLAY_FLAG_AUTO_SHIFT за рекордом следуют задержка и период
+ * автоповтора.
+ * @param recorder Указатель на состояние записи.
+ * @param path Путь к файлу записи.
+ * @param header Параметры игры; поле version заполняется автоматически.
+ * @return true Если файл создан и заголовок записан.
+ */
+bool recorder_open(Recorder_t *recorder, const char *path,
+                   const ReplayHeader_t *header) {
+  recorder->last_tick = 0;
+  recorder->file = fopen(path, "wb");
+  if (!recorder->file) return false;
+
+  uint8_t prefix[14];
+  memcpy(prefix, REPLAY_MAGIC, 4);
+  prefix[4] = REPLAY_VERSION;
+  prefix[5] = header->flags;
+  for (int i = 0; i < 8; i++) prefix[6 + i] = (uint8_t)(header->seed >> 8 * i);
+
+  bool ok = fwrite(prefix, 1, sizeof(prefix), recorder->file) ==
+                sizeof(prefix) &&
+            write_varint(recorder->file, (uint64_t)header->high_score);
+  if (ok && (header->flags & REPLAY_FLAG_AUTO_SHIFT)) {
+    ok = write_varint(recorder->file, (uint64_t)header->das) &&
+         write_varint(recorder->file, (uint64_t)header->arr);
+  }
+  ok = ok && fflush(recorder->file) == 0;
+  if (!ok) {
+    fclose(recorder->file);
+    recorder->file = NULL;
+  }
+  return ok;
+}
+
+/**
+ * @brief Записывает одно действие игрока.
+ *
+ * Событие кодируется одним varint: разница тиков с предыдущим событием,
+ * сдвинутая на REPLAY_ACTION_BITS, и код действия в младших битах.
+ * ActionNone не записывается: в конечном автомате это пустое действие.
+ * В записи с флагом REPLAY_FLAG_AUTO_SHIFT горизонтальные сдвиги
+ * записываются только через recorder_record_shift.
+ * Файл сбрасывается на диск после каждого события, чтобы при аварийном
+ * завершении запись сохранилась до последнего нажатия.
+ * @param recorder Указатель на состояние записи.
+ * @param tick Номер тика главного цикла, начиная с нуля.
+ * @param action Действие, переданное в apply_user_action.
+ * @return true Если событие записано (или записывать было нечего).
+ */
+bool recorder_record(Recorder_t *recorder, long tick, UserAction_t action) {
+  if (!recorder->file || action == ActionNone) return true;
+
+  uint64_t delta = (uint64_t)(tick - recorder->last_tick);
+  recorder->last_tick = tick;
+  return write_varint(recorder->file,
+                      delta << REPLAY_ACTION_BITS | (uint64_t)action) &&
+         fflush(recorder->file) == 0;
+}
+
+/**
+ * @brief Записывает нажатие или отпускание горизонтального сдвига.
+ *
+ * Событие записывается как ActionMoveLeft или ActionMoveRight, за которым
+ * следует varint: отставание момента time от конца тика в субтиках,
+ * сдвинутое на бит, и признак отпускания в младшем бите.
+ * @param recorder Указатель на состояние записи.
+ * @param tick Номер тика главного цикла.
+ * @param direction Направление: отрицательное — влево, иначе вправо.
+ * @param time Момент события в субтиках, переданный в press_shift или
+ * release_shift.
+ * @param released true — отпускание, false — нажатие.
+ * @return true Если событие записано.
+ */
+bool recorder_record_shift(Recorder_t *recorder, long tick, int direction,
+                           long time, bool released) {
+  if (!recorder->file) return true;
+
+  long lag = (tick + 1) * SUBTICKS_PER_TICK - 1 - time;
+  if (lag < 0) lag = 0;
+  UserAction_t action = direction < 0 ? ActionMoveLeft : ActionMoveRight;
+  uint64_t delta = (uint64_t)(tick - recorder->last_tick);
+  recorder->last_tick = tick;
+  return write_varint(recorder->file,
+                      delta << REPLAY_ACTION_BITS | (uint64_t)action) &&
+         write_varint(recorder->file, (uint64_t)lag << 1 | released) &&
+         fflush(recorder->file) == 0;
+}
+
+/**
+ * @brief Завершает запись меткой конца и закрывает файл.
+ *
+ * Метка конца — событие с кодом ActionNone, ее тик равен общему числу
+ * вызовов update_game_state за игру.
+ * @param recorder Указатель на состояние записи.
+ * @param tick Общее количество тиков игры.
+ * @return true Если метка записана и файл закрыт без ошибок.
+ */
+bool recorder_close(Recorder_t *recorder, long tick) {
+  if (!recorder->file) return false;
+
+  uint64_t delta = (uint64_t)(tick - recorder->last_tick);
+  bool ok = write_varint(recorder->file, delta << REPLAY_ACTION_BITS |
+                                             (uint64_t)ActionNone);
+  ok = fclose(recorder->file) == 0 && ok;
+  recorder->file = NULL;
+  return ok;
+}
+
+/**
+ * @brief Открывает файл записи и читает заголовок.
+ *
+ * @param reader Указатель на состояние чтения.
+ * @param path Путь к файлу записи.
+ * @return true Если файл открыт и заголовок корректен.
+ */
+bool replay_open(ReplayReader_t *reader, const char *path) {
+  reader->tick = 0;
+  reader->shift_time = 0;
+  reader->released = false;
+  reader->finished = false;
+  reader->file = fopen(path, "rb");
+  if (!reader->file) return false;
+
+  uint8_t prefix[14];
+  uint64_t high_score = 0, das = DEFAULT_DAS, arr = DEFAULT_ARR;
+  bool ok = fread(prefix, 1, sizeof(prefix), reader->file) == sizeof(prefix) &&
+            !memcmp(prefix, REPLAY_MAGIC, 4) && prefix[4] >= 1 &&
+            prefix[4] <= REPLAY_VERSION &&
+            read_varint(reader->file, &high_score);
+  if (ok && (prefix[5] & REPLAY_FLAG_AUTO_SHIFT)) {
+    ok = read_varint(reader->file, &das) && read_varint(reader->file, &arr);
+  }
+  if (!ok) {
+    replay_close(reader);
+    return false;
+  }
+
+  reader->header.version = prefix[4];
+  reader->header.flags = prefix[5];
+  reader->header.seed = 0;
+  for (int i = 0; i < 8; i++) {
+    reader->header.seed |= (uint64_t)prefix[6 + i] << 8 * i;
+  }
+  reader->header.high_score = (int)high_score;
+  reader->header.das = (int)das;
+  reader->header.arr = (int)arr;
+  return true;
+}
+
+/**
+ * @brief Читает следующее действие из записи.
+ *
+ * После метки конца (или обрыва файла) возвращает false, а в reader->tick
+ * остается общее количество тиков игры. Для горизонтальных сдвигов в
+ * записи с флагом REPLAY_FLAG_AUTO_SHIFT момент и признак отпускания
+ * сохраняются в reader->shift_time и reader->released.
+ * @param reader Указатель на состояние чтения.
+ * @param tick Указатель для номера тика события.
+ * @param action Указатель для действия.
+ * @return true Если событие прочитано.
+ */
+bool replay_next(ReplayReader_t *reader, long *tick, UserAction_t *action) {
+  if (reader->finished) return false;
+
+  uint64_t event;
+  if (!read_varint(reader->file, &event)) {
+    // Обрыв файла: игра доигрывается до тика последнего события
+    reader->tick++;
+    reader->finished = true;
+    return false;
+  }
+  reader->tick += (long)(event >> REPLAY_ACTION_BITS);
+  *tick = reader->tick;
+  *action = (UserAction_t)(event & ((1u << REPLAY_ACTION_BITS) - 1));
+  if (*action == ActionNone) reader->finished = true;
+
+  uint64_t shift;
+  if ((reader->header.flags & REPLAY_FLAG_AUTO_SHIFT) &&
+      (*action == ActionMoveLeft || *action == ActionMoveRight)) {
+    if (!read_varint(reader->file, &shift)) {
+      reader->tick++;
+      reader->finished = true;
+      return false;
+    }
+    reader->shift_time =
+        (reader->tick + 1) * SUBTICKS_PER_TICK - 1 - (long)(shift >> 1);
+    reader->released = shift & 1;
+  }
+  return !reader->finished;
+}
+
+/**
+ * @brief Закрывает файл записи.
+ *
+ * @param reader Указатель на состояние чтения.
+ */
+void replay_close(ReplayReader_t *reader) {
+  if (reader->file) fclose(reader->file);
+  reader->file = NULL;
+}
+
+/**
+ * @brief Инициализирует игру с параметрами из заголовка записи.
+ *
+ * @param reader Указатель на состояние чтения после replay_open.
+ * @param game Указатель на главную структуру данных игры.
+ */
+void replay_start_game(const ReplayReader_t *reader, GameData_t *game) {
+  initialize_game_core(game, reader->header.high_score, reader->header.seed);
+  if (reader->header.flags & REPLAY_FLAG_BAG7) {
+    set_randomizer(game, RandomizerBag7);
+  }
+  if (reader->header.flags & REPLAY_FLAG_SETTLE) {
+    set_settle_transitions(game, true);
+  }
+  if (reader->header.flags & REPLAY_FLAG_AUTO_SHIFT) {
+    set_auto_shift(game, reader->header.das, reader->header.arr);
+  }
+}
+
+/**
+ * @brief Применяет прочитанное событие записи к игре.
+ *
+ * Горизонтальные сдвиги записи с флагом REPLAY_FLAG_AUTO_SHIFT — это
+ * нажатия и отпускания (press_shift, release_shift), остальные события
+ * передаются в apply_user_action.
+ * @param reader Указатель на состояние чтения после replay_next.
+ * @param game Указатель на главную структуру данных игры.
+ * @param action Действие, возвращенное replay_next.
+ */
+void replay_apply(const ReplayReader_t *reader, GameData_t *game,
+                  UserAction_t action) {
+  bool horizontal = action == ActionMoveLeft || action == ActionMoveRight;
+  if (!(reader->header.flags & REPLAY_FLAG_AUTO_SHIFT) || !horizontal) {
+    apply_user_action(game, action);
+    return;
+  }
+
+  int direction = action == ActionMoveLeft ? -1 : 1;
+  if (reader->released)
+    release_shift(game, direction, reader->shift_time);
+  else
+    press_shift(game, direction, reader->shift_time);
+}
+
+/**
+ * @brief Повторяет записанную игру без задержек и отрисовки.
+ *
+ * На каждом тике применяются все действия этого тика, затем вызывается
+ * update_game_state — так же, как в главном цикле cmd/main.c. Тики без
+ * событий между действиями пропускаются через advance_game.
+ * @param path Путь к файлу записи.
+ * @param game Указатель на структуру, в которой окажется итоговая игра.
+ * @return long Количество воспроизведенных тиков или -1, если файл не
+ * удалось прочитать.
+ */
+long replay_run(const char *path, GameData_t *game) {
+  ReplayReader_t reader;
+  if (!replay_open(&reader, path)) return -1;
+  replay_start_game(&reader, game);
+
+  long tick = 0, event_tick = 0;
+  UserAction_t action = ActionNone;
+  bool pending = replay_next(&reader, &event_tick, &action);
+  for (;;) {
+    while (pending && event_tick == tick) {
+      replay_apply(&reader, game, action);
+      pending = replay_next(&reader, &event_tick, &action);
+    }
+    long target = pending ? event_tick : reader.tick;
+    advance_game(game, target - tick);
+    tick = target;
+    if (!pending) break;
+  }
+  replay_close(&reader);
+  return tick;
+}
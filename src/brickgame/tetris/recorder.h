@@ -0,0 +1,53 @@
+#ifndef BRICKGAME_TETRIS_RECORDER_H
+#define BRICKGAME_TETRIS_RECORDER_H
+
+#include <stdio.h>
+
+#include "brickgame/tetris/tetris_core.h"
+
+#define REPLAY_MAGIC "TTRP"
+#define REPLAY_VERSION 2
+#define REPLAY_FLAG_BAG7 0x01
+#define REPLAY_FLAG_SETTLE 0x02
+#define REPLAY_FLAG_AUTO_SHIFT 0x04
+#define REPLAY_ACTION_BITS 3
+
+typedef struct {
+  uint8_t version;
+  uint8_t flags;
+  uint64_t seed;
+  int high_score;
+  int das;
+  int arr;
+} ReplayHeader_t;
+
+typedef struct {
+  FILE *file;
+  long last_tick;
+} Recorder_t;
+
+typedef struct {
+  FILE *file;
+  ReplayHeader_t header;
+  long tick;
+  long shift_time;
+  bool released;
+  bool finished;
+} ReplayReader_t;
+
+bool recorder_open(Recorder_t *recorder, const char *path,
+                   const ReplayHeader_t *header);
+bool recorder_record(Recorder_t *recorder, long tick, UserAction_t action);
+bool recorder_record_shift(Recorder_t *recorder, long tick, int direction,
+                           long time, bool released);
+bool recorder_close(Recorder_t *recorder, long tick);
+
+bool replay_open(ReplayReader_t *reader, const char *path);
+bool replay_next(ReplayReader_t *reader, long *tick, UserAction_t *action);
+void replay_close(ReplayReader_t *reader);
+void replay_start_game(const ReplayReader_t *reader, GameData_t *game);
+void replay_apply(const ReplayReader_t *reader, GameData_t *game,
+                  UserAction_t action);
+long replay_run(const char *path, GameData_t *game);
+
+#endif
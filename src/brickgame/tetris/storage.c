@@ -0,0 +1,56 @@
+#include <stdio.h>
+
+#include "brickgame/tetris/tetris.h"
+
+/**
+ * @brief Инициализирует начальное состояние игры для интерактивного режима.
+ *
+ * Загружает рекорд из файла и передает управление initialize_game_core,
+ * засевая генератор фигур текущим временем.
+ * @param game Указатель на главную структуру данных игры.
+ */
+void initialize_game(GameData_t *game) {
+  initialize_game_seeded(game, (uint64_t)time(NULL));
+}
+
+/**
+ * @brief Инициализирует игру с рекордом из файла и заданным seed.
+ *
+ * Нужна, когда начальное значение генератора должно быть известно
+ * вызывающей стороне, например для записи игры в файл повтора.
+ * @param game Указатель на главную структуру данных игры.
+ * @param seed Начальное значение генератора фигур.
+ */
+void initialize_game_seeded(GameData_t *game, uint64_t seed) {
+  initialize_game_core(game, load_high_score(), seed);
+}
+
+/**
+ * @brief Загружает рекорд из файла "highscore.txt".
+ *
+ * @return int Загруженное значение рекорда, или 0, если файл не найден.
+ */
+int load_high_score() {
+  FILE *file = fopen("highscore.txt", "r");
+  if (file == NULL) {
+    return 0;
+  }
+  int score = 0;
+  fscanf(file, "%d", &score);
+  fclose(file);
+  return score;
+}
+
+/**
+ * @brief Сохраняет текущее значение рекорда в файл "highscore.txt".
+ *
+ * @param score Значение рекорда для сохранения.
+ */
+void save_high_score(int score) {
+  FILE *file = fopen("highscore.txt", "w");
+  if (file == NULL) {
+    return;
+  }
+  fprintf(file, "%d", score);
+  fclose(file);
+}
\ No newline at end of file
@@ -1,4 +1,9 @@
-#include "brickgame/tetris/tetris.h"
+#include "brickgame/tetris/tetris_core.h"
+
+#include <pthread.h>
+
+#define ZOBRIST_SEED 0x5A0B715Bu
+#define ZOBRIST_HALF_BITS (BOARD_WIDTH / 2)
 
 const int FIGURES[7][4][4] = {
     {{0, 0, 0, 0}, {0, 0, 0, 0}, {1, 1, 1, 1}, {0, 0, 0, 0}},  // I
@@ -10,33 +15,280 @@ const int FIGURES[7][4][4] = {
     {{0, 0, 0, 0}, {1, 1, 0, 0}, {0, 1, 1, 0}, {0, 0, 0, 0}}   // Z
 };
 
+PieceRotation_t PIECE_ROTATIONS[PIECE_COUNT][ROTATION_COUNT];
+
+static uint64_t ZOBRIST_ROWS[BOARD_HEIGHT][2][1u << ZOBRIST_HALF_BITS];
+
+static pthread_once_t piece_tables_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Заполняет таблицу одного поворота по матрице 4x4.
+ *
+ * Строит маски строк, нижний профиль (самую нижнюю занятую строку
+ * каждого столбца), допустимый диапазон x и маски, заранее сдвинутые на
+ * каждое допустимое смещение по x.
+ * @param rotation Заполняемый элемент таблицы поворотов.
+ * @param shape Матрица фигуры в данном повороте.
+ */
+static void build_piece_rotation(PieceRotation_t *rotation,
+                                 const int shape[4][4]) {
+  unsigned columns = 0;
+  for (int i = 0; i < 4; i++) {
+    rotation->rows[i] = 0;
+    for (int j = 0; j < 4; j++) {
+      if (shape[i][j]) rotation->rows[i] |= (uint16_t)(1u << j);
+    }
+    columns |= rotation->rows[i];
+  }
+  for (int j = 0; j < 4; j++) {
+    rotation->bottom[j] = -1;
+    for (int i = 0; i < 4; i++) {
+      if (rotation->rows[i] & (1u << j)) rotation->bottom[j] = (int8_t)i;
+    }
+  }
+
+  int left = 0, right = 3;
+  while (!(columns & (1u << left))) left++;
+  while (!(columns & (1u << right))) right--;
+  rotation->min_x = -left;
+  rotation->max_x = BOARD_WIDTH - 1 - right;
+  rotation->top = 0;
+  while (!rotation->rows[rotation->top]) rotation->top++;
+
+  memset(rotation->shifted, 0, sizeof(rotation->shifted));
+  for (int x = rotation->min_x; x <= rotation->max_x; x++) {
+    for (int i = 0; i < 4; i++) {
+      rotation->shifted[x - PIECE_MIN_X][i] =
+          (uint16_t)(x < 0 ? rotation->rows[i] >> -x : rotation->rows[i] << x);
+    }
+  }
+}
+
+/**
+ * @brief Проверяет, совпадают ли формы двух поворотов с точностью до сдвига.
+ *
+ * @param a Первый поворот.
+ * @param b Второй поворот.
+ * @return true Если повороты занимают одинаковый набор клеток.
+ */
+static bool same_shape(const PieceRotation_t *a, const PieceRotation_t *b) {
+  for (int i = 0; i < 4; i++) {
+    unsigned row_a = a->top + i < 4 ? a->rows[a->top + i] >> -a->min_x : 0;
+    unsigned row_b = b->top + i < 4 ? b->rows[b->top + i] >> -b->min_x : 0;
+    if (row_a != row_b) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Находит для каждого поворота первый поворот с той же формой.
+ *
+ * У симметричных фигур (O, I, S, Z) разные повороты дают одинаковые
+ * наборы клеток. Фигура в повороте r в точке (x, y) совпадает с фигурой
+ * в повороте canonical в точке (x + canonical_dx, y + canonical_dy).
+ * @param rotations Повороты одной фигуры.
+ */
+static void link_canonical_rotations(PieceRotation_t *rotations) {
+  for (int r = 0; r < ROTATION_COUNT; r++) {
+    int c = 0;
+    while (!same_shape(&rotations[c], &rotations[r])) c++;
+    rotations[r].canonical = c;
+    rotations[r].canonical_dx = rotations[c].min_x - rotations[r].min_x;
+    rotations[r].canonical_dy = rotations[r].top - rotations[c].top;
+  }
+}
+
+/**
+ * @brief Заполняет ключи Зобриста для клеток поля.
+ *
+ * Ключи берутся из PCG32 с фиксированным начальным значением, поэтому
+ * хэш одного и того же поля одинаков во всех запусках. Каждая клетка
+ * получает независимый ключ, но хранятся они сразу как XOR-суммы для
+ * всех наборов клеток левой и правой половины строки: вклад строки в хэш
+ * читается двумя обращениями к таблице вместо цикла по клеткам.
+ */
+static void build_zobrist_keys(void) {
+  Rng_t rng;
+  rng_seed(&rng, ZOBRIST_SEED);
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    uint64_t keys[BOARD_WIDTH];
+    for (int x = 0; x < BOARD_WIDTH; x++) {
+      uint64_t high = rng_next(&rng);
+      keys[x] = high << 32 | rng_next(&rng);
+    }
+    for (int half = 0; half < 2; half++) {
+      for (unsigned bits = 0; bits < 1u << ZOBRIST_HALF_BITS; bits++) {
+        uint64_t hash = 0;
+        for (int x = 0; x < ZOBRIST_HALF_BITS; x++) {
+          if (bits & (1u << x)) hash ^= keys[half * ZOBRIST_HALF_BITS + x];
+        }
+        ZOBRIST_ROWS[y][half][bits] = hash;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Строит таблицы всех поворотов для всех фигур FIGURES.
+ *
+ * Поворот k получается из поворота k-1 вращением матрицы на 90 градусов
+ * по часовой стрелке (транспонирование + отражение по горизонтали).
+ * Заодно заполняются ключи Зобриста клеток поля.
+ */
+static void build_piece_tables(void) {
+  build_zobrist_keys();
+  for (int piece = 0; piece < PIECE_COUNT; piece++) {
+    int shape[4][4];
+    memcpy(shape, FIGURES[piece], sizeof(shape));
+    for (int r = 0; r < ROTATION_COUNT; r++) {
+      build_piece_rotation(&PIECE_ROTATIONS[piece][r], shape);
+
+      int rotated[4][4];
+      for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+          rotated[i][j] = shape[3 - j][i];
+        }
+      }
+      memcpy(shape, rotated, sizeof(shape));
+    }
+    link_canonical_rotations(PIECE_ROTATIONS[piece]);
+  }
+}
+
+/**
+ * @brief Однократно инициализирует таблицы поворотов фигур и ключи поля.
+ *
+ * Безопасна для повторного и параллельного вызова. Вызывается из
+ * initialize_game, поэтому отдельный вызов обычно не нужен.
+ */
+void init_piece_tables(void) {
+  pthread_once(&piece_tables_once, build_piece_tables);
+}
+
+/**
+ * @brief Возвращает элемент таблицы для текущего поворота фигуры.
+ *
+ * @param piece Указатель на фигуру.
+ * @return const PieceRotation_t* Маски и допустимый диапазон x.
+ */
+const PieceRotation_t *piece_rotation(const CurrentPiece_t *piece) {
+  return &PIECE_ROTATIONS[piece->piece][piece->rotation];
+}
+
+/**
+ * @brief Проверяет, занята ли ячейка матрицы 4x4 фигуры.
+ *
+ * @param piece Указатель на фигуру.
+ * @param row Строка матрицы (0..3).
+ * @param col Столбец матрицы (0..3).
+ * @return true Если ячейка занята блоком фигуры.
+ */
+bool piece_cell(const CurrentPiece_t *piece, int row, int col) {
+  return (piece_rotation(piece)->rows[row] >> col) & 1u;
+}
+
 /**
  * @brief Генерирует индекс для следующей случайной фигуры.
  *
+ * Использует собственный генератор игры, а не глобальный rand(), поэтому
+ * последовательность фигур определяется только начальным значением.
+ * @param game Указатель на главную структуру данных игры.
  * @return int Индекс фигуры в массиве FIGURES (число от 0 до 6).
  */
-int generate_new_shape() {
-  return rand() % 7;
-  // return 0;
+int generate_new_shape(GameData_t *game) {
+  return piece_generator_next(&game->generator);
+}
+
+/**
+ * @brief Дополняет очередь предпросмотра целыми блоками генератора.
+ *
+ * Очередь хранит фигуры после next_piece_index; она пополняется, когда в
+ * ней меньше `length - 1` фигур, сразу блоком из piece_generator_block
+ * (мешком из семи фигур в режиме RandomizerBag7). Генератор вызывается
+ * раз в несколько появлений фигур, а не при каждом.
+ * @param game Указатель на главную структуру данных игры.
+ */
+static void refill_preview(GameData_t *game) {
+  PiecePreview_t *preview = &game->preview;
+  while (preview->count < preview->length - 1) {
+    uint8_t block[PIECE_COUNT];
+    int count = piece_generator_block(&game->generator, block);
+    for (int i = 0; i < count; i++) {
+      int slot = (preview->head + preview->count++) & (PREVIEW_RING - 1);
+      preview->pieces[slot] = block[i];
+    }
+  }
+}
+
+/**
+ * @brief Забирает из очереди фигуру, которая станет следующей.
+ *
+ * При длине предпросмотра 1 очередь не используется, и фигура берется
+ * прямо из генератора.
+ * @param game Указатель на главную структуру данных игры.
+ * @return int Индекс фигуры в массиве FIGURES.
+ */
+static int take_preview_piece(GameData_t *game) {
+  PiecePreview_t *preview = &game->preview;
+  if (!preview->count && preview->length <= 1) return generate_new_shape(game);
+
+  refill_preview(game);
+  int piece = preview->pieces[preview->head];
+  preview->head = (preview->head + 1) & (PREVIEW_RING - 1);
+  preview->count--;
+  refill_preview(game);
+  return piece;
+}
+
+/**
+ * @brief Задает, сколько следующих фигур игра знает заранее.
+ *
+ * Первая из них — next_piece_index, остальные хранятся в кольцевом буфере
+ * `game->preview` и читаются через preview_piece. Последовательность
+ * фигур от длины предпросмотра не зависит.
+ * @param game Указатель на главную структуру данных игры.
+ * @param length Длина предпросмотра; ограничивается диапазоном
+ * [1, PREVIEW_MAX].
+ */
+void set_preview_length(GameData_t *game, int length) {
+  if (length < 1) length = 1;
+  if (length > PREVIEW_MAX) length = PREVIEW_MAX;
+  game->preview.length = length;
+  refill_preview(game);
+}
+
+/**
+ * @brief Возвращает фигуру из предпросмотра.
+ *
+ * @param game Указатель на главную структуру данных игры.
+ * @param index 0 — следующая фигура (next_piece_index), 1 — та, что
+ * после нее, и так далее.
+ * @return int Индекс фигуры или -1, если фигура еще не известна.
+ */
+int preview_piece(const GameData_t *game, int index) {
+  const PiecePreview_t *preview = &game->preview;
+  if (index == 0) return game->next_piece_index;
+  if (index < 0 || index > preview->count) return -1;
+  return preview->pieces[(preview->head + index - 1) & (PREVIEW_RING - 1)];
 }
 
 /**
  * @brief Создает новую падающую фигуру вверху экрана.
  *
- * Копирует следующую фигуру в текущую, устанавливает начальные координаты
- * и проверяет на мгновенную коллизию (условие проигрыша).
+ * Делает следующую фигуру текущей (в начальном повороте), устанавливает
+ * начальные координаты и проверяет на мгновенную коллизию (условие
+ * проигрыша). Новая следующая фигура берется из очереди предпросмотра.
  * @param game Указатель на главную структуру данных игры.
  * @return true Если спавн прошел успешно.
  * @return false Если произошла коллизия (игра окончена).
  */
 bool spawn_new_piece(GameData_t *game) {
-  memcpy(game->current_piece.shape, FIGURES[game->next_piece_index],
-         sizeof(int) * 16);
-
-  game->current_piece.x = BOARD_WIDTH / 2 - 2;
-  game->current_piece.y = -2;
+  game->current_piece.piece = game->next_piece_index;
+  game->current_piece.rotation = 0;
+  game->current_piece.x = SPAWN_X;
+  game->current_piece.y = SPAWN_Y;
   game->current_piece.color_index = game->next_piece_index + 1;
-  game->next_piece_index = generate_new_shape();
+  game->next_piece_index = take_preview_piece(game);
 
   return !check_collision(game);
 }
@@ -59,75 +311,304 @@ void move_piece(GameData_t *game, int dx, int dy) {
   }
 }
 
+/**
+ * @brief Находит, докуда фигура может сдвинуться по горизонтали.
+ *
+ * Строки поля под фигурой читаются один раз, затем на каждом следующем x
+ * заранее сдвинутые маски поворота сравниваются с ними одной операцией
+ * AND, пока фигура не упрется в стену или блок.
+ * @param game Указатель на главную структуру данных игры.
+ * @param dx Желаемое смещение по оси X.
+ * @return int Координата x, до которой фигура доходит без столкновений.
+ */
+static int slide_target(const GameData_t *game, int dx) {
+  const PieceRotation_t *rotation = piece_rotation(&game->current_piece);
+  uint16_t below[4];
+  for (int i = 0; i < 4; i++) {
+    int board_y = game->current_piece.y + i;
+    below[i] = board_y >= 0 && board_y < BOARD_HEIGHT ? game->rows[board_y] : 0;
+  }
+
+  int step = dx < 0 ? -1 : 1;
+  int x = game->current_piece.x;
+  int target = x + dx;
+  if (target < rotation->min_x) target = rotation->min_x;
+  if (target > rotation->max_x) target = rotation->max_x;
+  while (x != target) {
+    const uint16_t *mask = rotation->shifted[x + step - PIECE_MIN_X];
+    if ((mask[0] & below[0]) | (mask[1] & below[1]) | (mask[2] & below[2]) |
+        (mask[3] & below[3]))
+      break;
+    x += step;
+  }
+  return x;
+}
+
+/**
+ * @brief Сдвигает текущую фигуру по горизонтали на несколько клеток.
+ *
+ * В отличие от |dx| вызовов move_piece, коллизии проверяются одним
+ * проходом (slide_target), а фигура останавливается у первого препятствия.
+ * @param game Указатель на главную структуру данных игры.
+ * @param dx Смещение по оси X; знак задает направление.
+ * @return int Количество клеток, на которое фигура сдвинулась.
+ */
+int slide_piece(GameData_t *game, int dx) {
+  int x = slide_target(game, dx);
+  int moved = abs(x - game->current_piece.x);
+  game->current_piece.x = x;
+  return moved;
+}
+
 /**
  * @brief Проверяет наличие столкновений для текущей фигуры.
- * * @param game Указатель на главную структуру данных игры.
+ *
+ * Выход за боковые стены отсекается по диапазону x из таблицы поворотов,
+ * затем каждая из 4 заранее сдвинутых масок строк фигуры проверяется
+ * одной операцией AND против соответствующей строки битовой доски `rows`.
+ * @param game Указатель на главную структуру данных игры.
  * @return true Если есть столкновение (со стеной, полом или другим блоком).
  * @return false Если столкновений нет.
  */
 bool check_collision(const GameData_t *game) {
+  const PieceRotation_t *rotation = piece_rotation(&game->current_piece);
+  int x = game->current_piece.x;
+  if (x < rotation->min_x || x > rotation->max_x) return true;
+
+  const uint16_t *mask = rotation->shifted[x - PIECE_MIN_X];
   for (int i = 0; i < 4; i++) {
-    for (int j = 0; j < 4; j++) {
-      if (game->current_piece.shape[i][j]) {
-        int board_x = game->current_piece.x + j;
-        int board_y = game->current_piece.y + i;
-        if (board_x < 0 || board_x >= BOARD_WIDTH || board_y >= BOARD_HEIGHT)
-          return true;
-        if (board_y >= 0 && game->board[board_y][board_x]) return true;
-      }
-    }
+    if (!mask[i]) continue;
+    int board_y = game->current_piece.y + i;
+    if (board_y >= BOARD_HEIGHT) return true;
+    if (board_y >= 0 && (game->rows[board_y] & mask[i])) return true;
   }
   return false;
 }
 
+/**
+ * @brief Находит расстояние падения перебором строк.
+ *
+ * Маски фигуры сравниваются со строками битовой доски на каждой
+ * следующей высоте, пока фигура не упрется в блок или пол.
+ * @param game Указатель на главную структуру данных игры.
+ * @return int На сколько строк фигура может опуститься.
+ */
+static int sweep_drop_distance(const GameData_t *game) {
+  const PieceRotation_t *rotation = piece_rotation(&game->current_piece);
+  const uint16_t *mask = rotation->shifted[game->current_piece.x - PIECE_MIN_X];
+  for (int drop = 0;; drop++) {
+    for (int i = 0; i < 4; i++) {
+      if (!mask[i]) continue;
+      int board_y = game->current_piece.y + drop + 1 + i;
+      if (board_y >= BOARD_HEIGHT) return drop;
+      if (board_y >= 0 && (game->rows[board_y] & mask[i])) return drop;
+    }
+  }
+}
+
+/**
+ * @brief Вычисляет падение текущей фигуры по профилю высот столбцов.
+ *
+ * Для каждого столбца фигуры нижняя клетка (PieceRotation_t.bottom)
+ * сравнивается с высотой столбца поля `heights`: падение — наименьший
+ * зазор, то есть не больше четырех сравнений вместо проверки коллизий на
+ * каждой строке. Если фигура уже ниже поверхности какого-либо столбца
+ * (стоит под навесом), профиль неоднозначен. Пока ответ однозначен, точка
+ * приземления не зависит от высоты фигуры.
+ * @param game Указатель на главную структуру данных игры; фигура должна
+ * стоять в допустимом положении.
+ * @return int Количество строк падения или -1, если профиль неоднозначен.
+ */
+int profile_drop_distance(const GameData_t *game) {
+  const PieceRotation_t *rotation = piece_rotation(&game->current_piece);
+  int drop = BOARD_HEIGHT;
+  for (int j = 0; j < 4; j++) {
+    if (rotation->bottom[j] < 0) continue;
+    int x = game->current_piece.x + j;
+    int y = game->current_piece.y + rotation->bottom[j];
+    int gap = BOARD_HEIGHT - game->heights[x] - 1 - y;
+    if (gap < 0) return -1;
+    if (gap < drop) drop = gap;
+  }
+  return drop;
+}
+
+/**
+ * @brief Вычисляет, на сколько строк текущая фигура упадет при сбросе.
+ *
+ * Расстояние берется из профиля высот (profile_drop_distance), а если
+ * профиль неоднозначен — перебором строк.
+ * @param game Указатель на главную структуру данных игры; фигура должна
+ * стоять в допустимом положении.
+ * @return int Количество строк падения.
+ */
+int drop_distance(const GameData_t *game) {
+  int drop = profile_drop_distance(game);
+  return drop >= 0 ? drop : sweep_drop_distance(game);
+}
+
+/**
+ * @brief Возвращает высоту столбца, просматривая битовую доску сверху.
+ *
+ * @param game Указатель на главную структуру данных игры.
+ * @param x Столбец.
+ * @return uint8_t Расстояние от пола до верхней занятой клетки столбца
+ * (0 — пустой столбец).
+ */
+static uint8_t column_height(const GameData_t *game, int x) {
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    if (game->rows[y] & (1u << x)) return (uint8_t)(BOARD_HEIGHT - y);
+  }
+  return 0;
+}
+
+/**
+ * @brief Возвращает вклад одной строки битовой доски в хэш поля.
+ *
+ * @param y Строка.
+ * @param row Битовая маска занятых клеток строки.
+ * @return uint64_t XOR ключей Зобриста занятых клеток.
+ */
+static uint64_t row_hash(int y, unsigned row) {
+  unsigned low = row & ((1u << ZOBRIST_HALF_BITS) - 1);
+  return ZOBRIST_ROWS[y][0][low] ^ ZOBRIST_ROWS[y][1][row >> ZOBRIST_HALF_BITS];
+}
+
+/**
+ * @brief Считает хэш Зобриста поля с нуля по битовой доске.
+ *
+ * Хэш зависит только от занятости клеток, а не от их цвета: для поиска
+ * поля с одинаковыми блоками неотличимы. Нужна для проверки `game->hash`,
+ * который движок поддерживает сам.
+ * @param game Указатель на главную структуру данных игры.
+ * @return uint64_t XOR ключей всех занятых клеток.
+ */
+uint64_t board_hash(const GameData_t *game) {
+  uint64_t hash = 0;
+  for (int y = 0; y < BOARD_HEIGHT; y++) hash ^= row_hash(y, game->rows[y]);
+  return hash;
+}
+
+/**
+ * @brief Пересчитывает производные данные поля по битовой доске.
+ *
+ * Высоты столбцов, маска полных строк и хэш Зобриста строятся заново.
+ * Нужна только после записи `rows` в обход set_board_cell (например,
+ * при копировании поля целиком).
+ * @param game Указатель на главную структуру данных игры.
+ */
+void refresh_board_summary(GameData_t *game) {
+  for (int x = 0; x < BOARD_WIDTH; x++) {
+    game->heights[x] = column_height(game, x);
+  }
+  game->full_rows = 0;
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    if (game->rows[y] == FULL_ROW_MASK) game->full_rows |= 1u << y;
+  }
+  game->hash = board_hash(game);
+}
+
+/**
+ * @brief Записывает ячейку игрового поля, поддерживая битовую доску.
+ *
+ * Единственный корректный способ менять поле снаружи движка: цветовой
+ * слой `board`, битовая доска `rows`, высоты столбцов `heights`, маска
+ * полных строк `full_rows` и хэш Зобриста `hash` обновляются
+ * согласованно, а счетчик `board_version` увеличивается. Столбец
+ * пересчитывается, только если очищается его верхняя клетка.
+ * @param game Указатель на главную структуру данных игры.
+ * @param x Столбец ячейки.
+ * @param y Строка ячейки.
+ * @param color Цвет ячейки (0 — пустая ячейка).
+ */
+void set_board_cell(GameData_t *game, int x, int y, int color) {
+  if (x < 0 || x >= BOARD_WIDTH || y < 0 || y >= BOARD_HEIGHT) return;
+
+  game->board[y][x] = (uint8_t)color;
+  game->board_version++;
+  if (((game->rows[y] >> x) & 1u) != (color != 0)) {
+    game->hash ^= row_hash(y, 1u << x);
+  }
+  if (color) {
+    game->rows[y] |= (uint16_t)(1u << x);
+    if (game->rows[y] == FULL_ROW_MASK) game->full_rows |= 1u << y;
+    if (game->heights[x] < BOARD_HEIGHT - y)
+      game->heights[x] = (uint8_t)(BOARD_HEIGHT - y);
+  } else {
+    game->rows[y] &= (uint16_t)~(1u << x);
+    game->full_rows &= ~(1u << y);
+    if (game->heights[x] == BOARD_HEIGHT - y)
+      game->heights[x] = column_height(game, x);
+  }
+}
+
 /**
  * @brief "Впечатывает" текущую падающую фигуру в игровое поле.
  *
- * Копирует блоки из `current_piece.shape` в `game->board`, делая
- * фигуру частью "стакана".
+ * Копирует блоки текущей фигуры в `game->board`, делая
+ * фигуру частью "стакана", и выставляет соответствующие биты в `rows`.
  * @param game Указатель на главную структуру данных игры.
  */
 void imprint_piece_to_board(GameData_t *game) {
+  const PieceRotation_t *rotation = piece_rotation(&game->current_piece);
   for (int i = 0; i < 4; i++) {
     for (int j = 0; j < 4; j++) {
-      if (game->current_piece.shape[i][j]) {
-        int board_y = game->current_piece.y + i;
-        int board_x = game->current_piece.x + j;
-        if (board_y >= 0 && board_y < BOARD_HEIGHT && board_x >= 0 &&
-            board_x < BOARD_WIDTH) {
-          game->board[board_y][board_x] = game->current_piece.color_index;
-        }
+      if (rotation->rows[i] & (1u << j)) {
+        set_board_cell(game, game->current_piece.x + j,
+                       game->current_piece.y + i,
+                       game->current_piece.color_index);
       }
     }
   }
 }
 
 /**
- * @brief Ищет, очищает заполненные линии и сдвигает поле вниз.
+ * @brief Очищает заполненные линии и сдвигает поле вниз.
  *
+ * Полные строки не ищутся: их маску `full_rows` поддерживает
+ * set_board_cell, так что без очистки функция сразу возвращает 0.
+ * Поле уплотняется за один проход снизу вверх — каждая уцелевшая строка
+ * копируется не больше одного раза, а строки ниже нижней очищенной не
+ * трогаются вовсе. Хэш Зобриста меняется только для очищенных и
+ * сдвинутых строк. Очищенные строки заполнены целиком, поэтому верх
+ * каждого столбца лежит не ниже самой верхней из них: высота столбца, у
+ * которого над ней есть блоки, просто уменьшается на число очищенных
+ * строк, и лишь столбцы с верхом в этой строке пересчитываются.
  * @param game Указатель на главную структуру данных игры.
  * @return int Количество очищенных линий.
  */
 int clear_lines(GameData_t *game) {
-  int cleared_lines = 0;
-  for (int y = BOARD_HEIGHT - 1; y >= 0; y--) {
-    bool line_is_full = true;
-    for (int x = 0; x < BOARD_WIDTH; x++) {
-      if (game->board[y][x] == 0) {
-        line_is_full = false;
-        break;
-      }
-    }
+  uint32_t full = game->full_rows;
+  if (!full) return 0;
 
-    if (line_is_full) {
+  int cleared_lines = 0;
+  int top_cleared = BOARD_HEIGHT;
+  int write = BOARD_HEIGHT - 1;
+  for (int read = BOARD_HEIGHT - 1; read >= 0; read--) {
+    if ((full >> read) & 1u) {
+      game->hash ^= row_hash(read, FULL_ROW_MASK);
+      top_cleared = read;
       cleared_lines++;
-      for (int move_y = y; move_y > 0; move_y--) {
-        memcpy(game->board[move_y], game->board[move_y - 1],
-               sizeof(int) * BOARD_WIDTH);
-      }
-      memset(game->board[0], 0, sizeof(int) * BOARD_WIDTH);
-      y++;
+      continue;
     }
+    if (write != read) {
+      game->hash ^= row_hash(read, game->rows[read]) ^
+                    row_hash(write, game->rows[read]);
+      game->rows[write] = game->rows[read];
+      memcpy(game->board[write], game->board[read], sizeof(game->board[0]));
+    }
+    write--;
+  }
+  memset(game->rows, 0, sizeof(game->rows[0]) * (size_t)(write + 1));
+  memset(game->board, 0, sizeof(game->board[0]) * (size_t)(write + 1));
+  game->full_rows = 0;
+
+  game->board_version++;
+  for (int x = 0; x < BOARD_WIDTH; x++) {
+    if (game->heights[x] > BOARD_HEIGHT - top_cleared)
+      game->heights[x] = (uint8_t)(game->heights[x] - cleared_lines);
+    else
+      game->heights[x] = column_height(game, x);
   }
   return cleared_lines;
 }
@@ -187,44 +668,184 @@ void update_level(GameInfo_t *info) {
 }
 
 /**
- * @brief Инициализирует начальное состояние игры.
- * * Очищает игровое поле, сбрасывает счет и уровень,
- * загружает рекорд, генерирует первую фигуру.
+ * @brief Инициализирует начальное состояние игры без ввода-вывода.
+ *
+ * Очищает игровое поле, сбрасывает счет и уровень, генерирует первую
+ * фигуру. Рекорд передается вызывающей стороной, файлы и терминал не
+ * используются, поэтому функция пригодна для безголовых симуляций.
  * @param game Указатель на главную структуру данных игры.
+ * @param high_score Рекорд, с которым начинается игра.
+ * @param seed Начальное значение генератора фигур: одинаковые значения
+ * дают одинаковые последовательности фигур.
  */
-void initialize_game(GameData_t *game) {
-  srand(time(NULL));
+void initialize_game_core(GameData_t *game, int high_score, uint64_t seed) {
+  init_piece_tables();
+  memset(game->rows, 0, sizeof(game->rows));
   memset(game->board, 0, sizeof(game->board));
+  memset(game->heights, 0, sizeof(game->heights));
+  game->full_rows = 0;
+  game->board_version = 0;
+  game->hash = 0;
+  memset(&game->current_piece, 0, sizeof(game->current_piece));
 
-  int high_score = load_high_score();
   game->info = (GameInfo_t){0, high_score, 1, 0, false};
 
-  game->next_piece_index = generate_new_shape();
+  piece_generator_seed(&game->generator, seed, RandomizerUniform);
+  game->next_piece_index = generate_new_shape(game);
+  game->preview = (PiecePreview_t){{0}, 0, 0, 1};
   game->state = Start;
 
-  game->timer.ticker = 0;
+  game->timer.tick = 0;
+  game->timer.next_shift_tick = 0;
   game->timer.speed_threshold = 20;
+  game->auto_shift = (AutoShift_t){DEFAULT_DAS, DEFAULT_ARR, 0, 0};
+  game->piece_count = 0;
+  game->settle_transitions = false;
+}
+
+/**
+ * @brief Переключает способ генерации фигур.
+ *
+ * Текущий "мешок" и очередь предпросмотра сбрасываются, следующие фигуры
+ * выбираются заново уже новым способом. Состояние генератора при этом не
+ * пересеивается.
+ * @param game Указатель на главную структуру данных игры.
+ * @param mode Способ генерации (RandomizerUniform или RandomizerBag7).
+ */
+void set_randomizer(GameData_t *game, Randomizer_t mode) {
+  game->generator.mode = mode;
+  game->generator.bag_pos = PIECE_COUNT;
+  game->next_piece_index = generate_new_shape(game);
+  game->preview.count = 0;
+  refill_preview(game);
+}
+
+/**
+ * @brief Включает или выключает завершение переходов за один тик.
+ *
+ * По умолчанию update_game_state выполняет ровно один переход автомата
+ * за вызов, и цепочка Shifting -> Attaching -> Spawn -> Moving занимает
+ * несколько тиков. В режиме завершения промежуточные состояния (Spawn,
+ * Shifting, Attaching) проходятся в том же тике, пока игра не придет в
+ * устойчивое состояние (Moving или GameOver).
+ * @param game Указатель на главную структуру данных игры.
+ * @param enabled true — завершать переходы за один тик.
+ */
+void set_settle_transitions(GameData_t *game, bool enabled) {
+  game->settle_transitions = enabled;
+}
+
+/**
+ * @brief Задает задержку и период автоповтора горизонтального сдвига.
+ *
+ * Удерживаемое направление (press_shift) сдвигает фигуру на клетку сразу,
+ * затем, спустя das субтиков, — на клетку каждые arr субтиков. При arr,
+ * равном 0, фигура после задержки сразу доезжает до препятствия. Субтик —
+ * 1/SUBTICKS_PER_TICK тика, поэтому сдвиги не привязаны к границам тиков:
+ * за один тик их может выполниться несколько.
+ * @param game Указатель на главную структуру данных игры.
+ * @param das Задержка автоповтора в субтиках.
+ * @param arr Период автоповтора в субтиках.
+ */
+void set_auto_shift(GameData_t *game, int das, int arr) {
+  game->auto_shift.das = das > 0 ? das : 0;
+  game->auto_shift.arr = arr > 0 ? arr : 0;
+}
+
+/**
+ * @brief Переводит смещение внутри текущего тика в отметку времени.
+ *
+ * @param game Указатель на главную структуру данных игры.
+ * @param offset Субтик от начала тика, который выполнится следующим;
+ * отрицательные значения указывают на прошлые тики.
+ * @return long Отметка времени игровых часов в субтиках.
+ */
+long game_subtick(const GameData_t *game, int offset) {
+  return game->timer.tick * SUBTICKS_PER_TICK + offset;
 }
 
 /**
- * @brief Преобразует код нажатой клавиши в игровое действие.
+ * @brief Возвращает срок первого автосдвига не раньше заданного момента.
  *
- * Является "чистой" функцией, которая не меняет состояние игры, а только
- * сопоставляет код клавиши (например, KEY_UP) с действием перечисления
- * (например, ActionRotate).
- * @param key Код клавиши, полученный от ncurses (например, getch()).
- * @return Соответствующее игровое действие типа UserAction_t.
+ * Сдвиги, пропущенные, пока фигура стояла у препятствия, не копятся:
+ * срок переносится на ближайший момент сетки с шагом arr.
+ * @param shift Состояние автоповтора.
+ * @param from Отметка времени в субтиках.
+ * @return long Срок следующего сдвига в субтиках.
  */
-UserAction_t get_user_action(int key) {
-  if (key == ERR) return ActionNone;
-  if (key == 'q' || key == 'Q') return ActionTerminate;
-  if (key == 'p' || key == 'P') return ActionPause;
-  if (key == KEY_ENTER || key == '\n') return ActionStart;
-  if (key == KEY_LEFT) return ActionMoveLeft;
-  if (key == KEY_RIGHT) return ActionMoveRight;
-  if (key == KEY_DOWN) return ActionMoveDown;
-  if (key == KEY_UP) return ActionRotate;
-  return ActionNone;
+static long next_auto_shift(const AutoShift_t *shift, long from) {
+  if (shift->next_shift >= from) return shift->next_shift;
+  if (!shift->arr) return from;
+  long missed = (from - shift->next_shift + shift->arr - 1) / shift->arr;
+  return shift->next_shift + missed * shift->arr;
+}
+
+/**
+ * @brief Выполняет автосдвиги со сроками в промежутке [from, until).
+ *
+ * Все сдвиги промежутка выполняются за один вызов slide_piece.
+ * @param game Указатель на главную структуру данных игры.
+ * @param from Начало промежутка в субтиках.
+ * @param until Конец промежутка в субтиках (не включительно).
+ */
+static void run_auto_shift(GameData_t *game, long from, long until) {
+  AutoShift_t *shift = &game->auto_shift;
+  if (!shift->direction) return;
+
+  long due = next_auto_shift(shift, from);
+  if (due >= until) return;
+  int cells = BOARD_WIDTH;
+  if (shift->arr) {
+    long count = (until - 1 - due) / shift->arr + 1;
+    if (count < cells) cells = (int)count;
+    shift->next_shift = due + count * shift->arr;
+  } else {
+    shift->next_shift = due;
+  }
+  if (game->state == Moving) slide_piece(game, shift->direction * cells);
+}
+
+/**
+ * @brief Начинает удержание горизонтального сдвига.
+ *
+ * Фигура сразу сдвигается на одну клетку, а автоповтор отсчитывается от
+ * момента нажатия time. Момент может лежать в прошлом: так клавиша,
+ * удержание которой обнаружилось не сразу, получает уже набранную
+ * задержку. Новое нажатие заменяет удерживаемое направление.
+ * @param game Указатель на главную структуру данных игры.
+ * @param direction Направление: отрицательное — влево, иначе вправо.
+ * @param time Момент нажатия в субтиках (game_subtick); не позже конца
+ * текущего тика.
+ */
+void press_shift(GameData_t *game, int direction, long time) {
+  if (game->info.pause || game->state == Start || game->state == GameOver)
+    return;
+
+  long end = game_subtick(game, SUBTICKS_PER_TICK - 1);
+  AutoShift_t *shift = &game->auto_shift;
+  shift->direction = direction < 0 ? -1 : 1;
+  shift->next_shift = (time < end ? time : end) + shift->das;
+  if (game->state == Moving) slide_piece(game, shift->direction);
+}
+
+/**
+ * @brief Завершает удержание горизонтального сдвига.
+ *
+ * Автосдвиги текущего тика, срок которых наступил до отпускания,
+ * выполняются; отпускание другого направления игнорируется.
+ * @param game Указатель на главную структуру данных игры.
+ * @param direction Отпускаемое направление.
+ * @param time Момент отпускания в субтиках (game_subtick).
+ */
+void release_shift(GameData_t *game, int direction, long time) {
+  AutoShift_t *shift = &game->auto_shift;
+  if (shift->direction != (direction < 0 ? -1 : 1)) return;
+
+  if (!game->info.pause) {
+    long end = game_subtick(game, SUBTICKS_PER_TICK);
+    run_auto_shift(game, game_subtick(game, 0), time < end ? time : end);
+  }
+  shift->direction = 0;
 }
 
 /**
@@ -265,38 +886,25 @@ void apply_user_action(GameData_t *game, UserAction_t action) {
         game->current_piece = temp;
       }
     } else if (action == ActionMoveDown) {
-      while (!check_collision(game)) {
-        game->current_piece.y++;
-      }
-      game->current_piece.y--;
+      game->current_piece.y += drop_distance(game);
       game->state = Attaching;
     }
   }
 }
 
 /**
- * @brief Обновляет состояние игры на основе таймера и текущего состояния.
+ * @brief Выполняет один переход конечного автомата.
  *
- * Эта функция является "сердцем" конечного автомата. Она отвечает за
- * автоматические переходы состояний, такие как падение фигуры по таймеру
- * (Shifting) или ее "прилипание" к полю (Attaching).
  * @param game Указатель на главную структуру данных игры.
+ * @param now Номер текущего тика.
  */
-void update_game_state(GameData_t *game) {
-  if (game->info.pause) return;
-
-  if (game->state == Moving) {
-    if (game->timer.ticker > game->timer.speed_threshold - game->info.level) {
-      game->state = Shifting;
-      game->timer.ticker = 0;
-    }
-    game->timer.ticker++;
-  }
-
+static void run_transition(GameData_t *game, long now) {
   switch (game->state) {
     case Spawn:
       if (spawn_new_piece(game)) {
         game->state = Moving;
+        game->timer.next_shift_tick = now + gravity_interval(game);
+        game->piece_count++;
       } else {
         game->state = GameOver;
       }
@@ -328,54 +936,124 @@ void update_game_state(GameData_t *game) {
 }
 
 /**
- * @brief Выполняет вращение текущей фигуры на 90 градусов по часовой стрелке.
+ * @brief Обновляет состояние игры на основе таймера и текущего состояния.
  *
- * Модифицирует матрицу `shape` в `game->current_piece`.
+ * Эта функция является "сердцем" конечного автомата. Она отвечает за
+ * автоматические переходы состояний, такие как падение фигуры по таймеру
+ * (Shifting) или ее "прилипание" к полю (Attaching). Каждый вызов — один
+ * тик игровых часов `timer.tick`; на паузе часы стоят. Падение происходит,
+ * когда часы доходят до срока `timer.next_shift_tick`; перед ним
+ * выполняются автосдвиги удерживаемого направления, срок которых попадает
+ * в этот тик (press_shift). Если включен режим
+ * set_settle_transitions, промежуточные состояния проходятся в том же
+ * тике.
  * @param game Указатель на главную структуру данных игры.
  */
-void rotate_piece(GameData_t *game) {
-  int temp_shape[4][4] = {0};
-  for (int i = 0; i < 4; i++) {
-    for (int j = 0; j < 4; j++) {
-      temp_shape[i][j] = game->current_piece.shape[j][i];
-    }
+void update_game_state(GameData_t *game) {
+  if (game->info.pause) return;
+
+  long now = game->timer.tick++;
+  run_auto_shift(game, now * SUBTICKS_PER_TICK,
+                 (now + 1) * SUBTICKS_PER_TICK);
+  if (game->state == Moving && now >= game->timer.next_shift_tick) {
+    game->state = Shifting;
+    game->timer.next_shift_tick = now + gravity_interval(game);
   }
-  for (int i = 0; i < 4; i++) {
-    for (int j = 0; j < 4 / 2; j++) {
-      int temp = temp_shape[i][j];
-      temp_shape[i][j] = temp_shape[i][3 - j];
-      temp_shape[i][3 - j] = temp;
-    }
+
+  run_transition(game, now);
+  while (game->settle_transitions &&
+         (game->state == Spawn || game->state == Shifting ||
+          game->state == Attaching)) {
+    run_transition(game, now);
   }
-  memcpy(game->current_piece.shape, temp_shape, sizeof(int) * 16);
 }
 
 /**
- * @brief Загружает рекорд из файла "highscore.txt".
+ * @brief Возвращает интервал между шагами падения фигуры в тиках.
+ *
+ * @param game Указатель на главную структуру данных игры.
+ * @return int Количество тиков между шагами (не меньше 1); с ростом
+ * уровня интервал сокращается.
+ */
+int gravity_interval(const GameData_t *game) {
+  int interval = game->timer.speed_threshold - game->info.level + 1;
+  return interval > 0 ? interval : 1;
+}
+
+/**
+ * @brief Сообщает, на каком тике update_game_state изменит игру сама.
  *
- * @return int Загруженное значение рекорда, или 0, если файл не найден.
+ * До этого тика вызовы update_game_state без действий игрока ничего не
+ * меняют, кроме часов и срока автоповтора фигуры, упершейся в
+ * препятствие, поэтому их можно пропустить (skip_to_tick), а интерактивный
+ * цикл может спать до этого срока.
+ * @param game Указатель на главную структуру данных игры.
+ * @return long Номер тика следующего события; текущий тик, если переход
+ * ожидается немедленно; -1, если без ввода событий не будет (заставка,
+ * пауза, конец игры).
  */
-int load_high_score() {
-  FILE *file = fopen("highscore.txt", "r");
-  if (file == NULL) {
-    return 0;
+long next_event_tick(const GameData_t *game) {
+  if (game->info.pause || game->state == Start || game->state == GameOver) {
+    return -1;
+  }
+  if (game->state != Moving || game->timer.next_shift_tick < game->timer.tick)
+    return game->timer.tick;
+
+  long next = game->timer.next_shift_tick;
+  const AutoShift_t *shift = &game->auto_shift;
+  if (shift->direction &&
+      slide_target(game, shift->direction) != game->current_piece.x) {
+    long due = next_auto_shift(shift, game_subtick(game, 0));
+    if (due / SUBTICKS_PER_TICK < next) next = due / SUBTICKS_PER_TICK;
   }
-  int score = 0;
-  fscanf(file, "%d", &score);
-  fclose(file);
-  return score;
+  return next;
 }
 
 /**
- * @brief Сохраняет текущее значение рекорда в файл "highscore.txt".
+ * @brief Переводит игровые часы вперед, пропуская пустые тики.
  *
- * @param score Значение рекорда для сохранения.
+ * Часы не переводятся дальше тика следующего события, поэтому результат
+ * совпадает с тем, что дали бы вызовы update_game_state по одному.
+ * @param game Указатель на главную структуру данных игры.
+ * @param tick Желаемый номер тика.
+ * @return long Номер тика, до которого удалось дойти.
  */
-void save_high_score(int score) {
-  FILE *file = fopen("highscore.txt", "w");
-  if (file == NULL) {
-    return;
+long skip_to_tick(GameData_t *game, long tick) {
+  if (game->info.pause) return game->timer.tick;
+
+  long next = next_event_tick(game);
+  if (next >= 0 && tick > next) tick = next;
+  if (tick > game->timer.tick) game->timer.tick = tick;
+  return game->timer.tick;
+}
+
+/**
+ * @brief Продвигает игру на заданное количество тиков.
+ *
+ * Эквивалентно ticks вызовам update_game_state, но пустые тики между
+ * событиями пропускаются за одну операцию.
+ * @param game Указатель на главную структуру данных игры.
+ * @param ticks Количество тиков.
+ */
+void advance_game(GameData_t *game, long ticks) {
+  while (ticks > 0 && !game->info.pause) {
+    long before = game->timer.tick;
+    ticks -= skip_to_tick(game, before + ticks) - before;
+    if (ticks > 0) {
+      update_game_state(game);
+      ticks--;
+    }
   }
-  fprintf(file, "%d", score);
-  fclose(file);
+}
+
+/**
+ * @brief Выполняет вращение текущей фигуры на 90 градусов по часовой стрелке.
+ *
+ * Переключает индекс поворота в `game->current_piece`; формы всех
+ * поворотов заранее построены в PIECE_ROTATIONS.
+ * @param game Указатель на главную структуру данных игры.
+ */
+void rotate_piece(GameData_t *game) {
+  game->current_piece.rotation =
+      (game->current_piece.rotation + 1) % ROTATION_COUNT;
 }
\ No newline at end of file
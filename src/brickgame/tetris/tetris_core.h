@@ -0,0 +1,191 @@
+#ifndef BRICKGAME_TETRIS_CORE_H
+#define BRICKGAME_TETRIS_CORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern const int FIGURES[7][4][4];
+
+#define BOARD_WIDTH 10
+#define BOARD_HEIGHT 20
+
+#define FULL_ROW_MASK ((1u << BOARD_WIDTH) - 1)
+
+#define PIECE_COUNT 7
+#define ROTATION_COUNT 4
+#define PIECE_MIN_X (-3)
+#define PIECE_X_SLOTS (BOARD_WIDTH - PIECE_MIN_X)
+
+#define PREVIEW_MAX 8
+#define PREVIEW_RING 16
+
+#define SPAWN_X (BOARD_WIDTH / 2 - 2)
+#define SPAWN_Y (-2)
+
+#define SUBTICKS_PER_TICK 16
+#define DEFAULT_DAS (4 * SUBTICKS_PER_TICK)
+#define DEFAULT_ARR (SUBTICKS_PER_TICK / 2)
+
+#define PTS_TILL_LVLUP 600
+#define MAX_LEVEL 10
+
+#define COLOR_I 1
+#define COLOR_O 2
+#define COLOR_T 3
+#define COLOR_L 4
+#define COLOR_J 5
+#define COLOR_S 6
+#define COLOR_Z 7
+
+typedef enum {
+  ActionNone,
+  ActionStart,
+  ActionPause,
+  ActionTerminate,
+  ActionMoveLeft,
+  ActionMoveRight,
+  ActionMoveDown,
+  ActionRotate
+} UserAction_t;
+
+typedef enum {
+  Start,
+  Spawn,
+  Moving,
+  Shifting,
+  Attaching,
+  GameOver
+} GameState_t;
+
+typedef struct {
+  uint16_t rows[4];
+  int8_t bottom[4];
+  int min_x;
+  int max_x;
+  int top;
+  int canonical;
+  int canonical_dx;
+  int canonical_dy;
+  uint16_t shifted[PIECE_X_SLOTS][4];
+} PieceRotation_t;
+
+extern PieceRotation_t PIECE_ROTATIONS[PIECE_COUNT][ROTATION_COUNT];
+
+typedef struct {
+  int piece;
+  int rotation;
+  int x;
+  int y;
+  int color_index;
+} CurrentPiece_t;
+
+typedef enum { RandomizerUniform, RandomizerBag7 } Randomizer_t;
+
+typedef struct {
+  uint64_t state;
+} Rng_t;
+
+typedef struct {
+  Rng_t rng;
+  Randomizer_t mode;
+  uint8_t bag[PIECE_COUNT];
+  int bag_pos;
+} PieceGenerator_t;
+
+typedef struct {
+  uint8_t pieces[PREVIEW_RING];
+  int head;
+  int count;
+  int length;
+} PiecePreview_t;
+
+typedef struct {
+  int score;
+  int high_score;
+  int level;
+  int speed;
+  bool pause;
+} GameInfo_t;
+
+typedef struct {
+  long tick;
+  long next_shift_tick;
+  int speed_threshold;
+} Timer_t;
+
+typedef struct {
+  int das;
+  int arr;
+  int direction;
+  long next_shift;
+} AutoShift_t;
+
+typedef struct {
+  uint16_t rows[BOARD_HEIGHT];
+  uint8_t board[BOARD_HEIGHT][BOARD_WIDTH];
+  uint8_t heights[BOARD_WIDTH];
+  uint32_t full_rows;
+  uint32_t board_version;
+  uint64_t hash;
+  int next_piece_index;
+  PiecePreview_t preview;
+  GameInfo_t info;
+  GameState_t state;
+  CurrentPiece_t current_piece;
+  Timer_t timer;
+  AutoShift_t auto_shift;
+  PieceGenerator_t generator;
+  long piece_count;
+  bool settle_transitions;
+} GameData_t;
+
+void initialize_game_core(GameData_t *game, int high_score, uint64_t seed);
+void set_randomizer(GameData_t *game, Randomizer_t mode);
+void set_settle_transitions(GameData_t *game, bool enabled);
+void update_game_state(GameData_t *game);
+int gravity_interval(const GameData_t *game);
+long next_event_tick(const GameData_t *game);
+long skip_to_tick(GameData_t *game, long tick);
+void advance_game(GameData_t *game, long ticks);
+
+void apply_user_action(GameData_t *game, UserAction_t action);
+void set_auto_shift(GameData_t *game, int das, int arr);
+long game_subtick(const GameData_t *game, int offset);
+void press_shift(GameData_t *game, int direction, long time);
+void release_shift(GameData_t *game, int direction, long time);
+
+void init_piece_tables(void);
+const PieceRotation_t *piece_rotation(const CurrentPiece_t *piece);
+bool piece_cell(const CurrentPiece_t *piece, int row, int col);
+
+void rng_seed(Rng_t *rng, uint64_t seed);
+uint32_t rng_next(Rng_t *rng);
+uint32_t rng_below(Rng_t *rng, uint32_t bound);
+void piece_generator_seed(PieceGenerator_t *generator, uint64_t seed,
+                          Randomizer_t mode);
+int piece_generator_next(PieceGenerator_t *generator);
+int piece_generator_block(PieceGenerator_t *generator, uint8_t *pieces);
+
+int generate_new_shape(GameData_t *game);
+void set_preview_length(GameData_t *game, int length);
+int preview_piece(const GameData_t *game, int index);
+void rotate_piece(GameData_t *game);
+void imprint_piece_to_board(GameData_t *game);
+void move_piece(GameData_t *game, int dx, int dy);
+int slide_piece(GameData_t *game, int dx);
+int profile_drop_distance(const GameData_t *game);
+int drop_distance(const GameData_t *game);
+bool spawn_new_piece(GameData_t *game);
+bool check_collision(const GameData_t *game);
+void set_board_cell(GameData_t *game, int x, int y, int color);
+void refresh_board_summary(GameData_t *game);
+uint64_t board_hash(const GameData_t *game);
+
+int clear_lines(GameData_t *game);
+void update_level(GameInfo_t *info);
+void add_score(GameInfo_t *info, int cleared_lines);
+void process_scoring_and_levelup(GameData_t *game);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "brickgame/tetris/ttable.h"
+
+/**
+ * @brief Создает таблицу транспозиций заданного размера.
+ *
+ * Таблица состоит из корзин по TTABLE_WAYS записей; корзина занимает
+ * ровно одну строку кэша (64 байта) и выровнена по ней, поэтому поиск
+ * ключа читает одну строку. Число корзин — наибольшая степень двойки,
+ * помещающаяся в bytes (но не меньше одной). Память выделяется один раз,
+ * поиск и запись ее не запрашивают.
+ * @param bytes Желаемый размер таблицы в байтах.
+ * @return TTable_t* Пустая таблица или NULL при нехватке памяти.
+ */
+TTable_t *ttable_create(size_t bytes) {
+  TTable_t *table = calloc(1, sizeof(TTable_t));
+  if (table == NULL) return NULL;
+
+  size_t count = 1;
+  while (count * 2 * sizeof(TTableBucket_t) <= bytes) count *= 2;
+  table->mask = count - 1;
+  table->buckets = aligned_alloc(64, count * sizeof(TTableBucket_t));
+  if (table->buckets == NULL) {
+    ttable_destroy(table);
+    return NULL;
+  }
+  ttable_clear(table);
+  return table;
+}
+
+/**
+ * @brief Освобождает таблицу транспозиций.
+ *
+ * @param table Указатель на таблицу (NULL допускается).
+ */
+void ttable_destroy(TTable_t *table) {
+  if (table == NULL) return;
+  free(table->buckets);
+  free(table);
+}
+
+/**
+ * @brief Удаляет все записи и обнуляет счетчики таблицы.
+ *
+ * @param table Указатель на таблицу.
+ */
+void ttable_clear(TTable_t *table) {
+  memset(table->buckets, 0, (table->mask + 1) * sizeof(TTableBucket_t));
+  table->probes = 0;
+  table->hits = 0;
+  table->stores = 0;
+}
+
+/**
+ * @brief Строит ключ позиции для таблицы транспозиций.
+ *
+ * Хэш Зобриста поля (game->hash) смешивается с текущей и следующей
+ * фигурой и глубиной поиска, поэтому одно поле, до которого поиск дошел
+ * разными порядками расстановок, дает один ключ. Ключ 0 означает пустую
+ * запись и не возвращается.
+ * @param board_hash Хэш Зобриста поля.
+ * @param piece Текущая фигура.
+ * @param next_piece Следующая фигура или TTABLE_NO_PIECE.
+ * @param depth Оставшаяся глубина поиска.
+ * @return uint64_t Ненулевой ключ позиции.
+ */
+uint64_t ttable_key(uint64_t board_hash, int piece, int next_piece,
+                    int depth) {
+  uint64_t z = (uint64_t)(piece + 1) | (uint64_t)(next_piece + 1) << 8 |
+               (uint64_t)depth << 16;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  uint64_t key = board_hash ^ z ^ (z >> 31);
+  return key ? key : 1;
+}
+
+/**
+ * @brief Ищет значение позиции в таблице.
+ *
+ * @param table Указатель на таблицу.
+ * @param key Ключ из ttable_key.
+ * @param value Куда записать найденное значение.
+ * @return bool true, если ключ найден.
+ */
+bool ttable_probe(TTable_t *table, uint64_t key, int64_t *value) {
+  const TTableBucket_t *bucket = &table->buckets[key & table->mask];
+  table->probes++;
+  for (int i = 0; i < TTABLE_WAYS; i++) {
+    if (bucket->entries[i].key == key) {
+      *value = bucket->entries[i].value;
+      table->hits++;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Записывает значение позиции в таблицу.
+ *
+ * Новая запись встает в начало корзины, остальные сдвигаются; при
+ * переполнении вытесняется самая давняя. Если ключ уже есть, его старая
+ * запись убирается, так что дубликатов в корзине не бывает.
+ * @param table Указатель на таблицу.
+ * @param key Ключ из ttable_key.
+ * @param value Значение позиции.
+ */
+void ttable_store(TTable_t *table, uint64_t key, int64_t value) {
+  TTableEntry_t *entries = table->buckets[key & table->mask].entries;
+  int last = TTABLE_WAYS - 1;
+  for (int i = 0; i < last; i++) {
+    if (entries[i].key == key) last = i;
+  }
+  memmove(&entries[1], &entries[0], sizeof(entries[0]) * (size_t)last);
+  entries[0] = (TTableEntry_t){key, value};
+  table->stores++;
+}
@@ -0,0 +1,34 @@
+#ifndef BRICKGAME_TETRIS_TTABLE_H
+#define BRICKGAME_TETRIS_TTABLE_H
+
+#include "brickgame/tetris/tetris_core.h"
+
+#define TTABLE_WAYS 4
+#define TTABLE_NO_PIECE (-1)
+
+typedef struct {
+  uint64_t key;
+  int64_t value;
+} TTableEntry_t;
+
+typedef struct {
+  _Alignas(64) TTableEntry_t entries[TTABLE_WAYS];
+} TTableBucket_t;
+
+typedef struct {
+  TTableBucket_t *buckets;
+  uint64_t mask;
+  long probes;
+  long hits;
+  long stores;
+} TTable_t;
+
+TTable_t *ttable_create(size_t bytes);
+void ttable_destroy(TTable_t *table);
+void ttable_clear(TTable_t *table);
+uint64_t ttable_key(uint64_t board_hash, int piece, int next_piece,
+                    int depth);
+bool ttable_probe(TTable_t *table, uint64_t key, int64_t *value);
+void ttable_store(TTable_t *table, uint64_t key, int64_t value);
+
+#endif
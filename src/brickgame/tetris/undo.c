@@ -0,0 +1,125 @@
+#include "brickgame/tetris/undo.h"
+
+/**
+ * @brief Опустошает стек отмены.
+ *
+ * @param stack Стек отмены.
+ */
+void undo_reset(UndoStack_t *stack) { stack->depth = 0; }
+
+/**
+ * @brief Фиксирует фигуру на поле с записью в журнал отмены.
+ *
+ * Делает то же, что play_placement: ставит фигуру текущей, впечатывает ее
+ * в поле, очищает заполненные линии и начисляет очки. В журнал попадает
+ * только то, что при этом меняется: прежние значения клеток под фигурой,
+ * цвета очищенных строк (битовые строки у них заведомо полные), высоты
+ * столбцов, хэш поля, GameInfo_t и прежняя текущая фигура.
+ * Записи лежат в заранее выделенном стеке, память не запрашивается.
+ * @param stack Стек отмены.
+ * @param game Указатель на главную структуру данных игры. Поле не должно
+ * содержать заполненных строк, как после любого вызова clear_lines.
+ * @param piece Фигура в конечном положении.
+ * @return bool false, если стек полон или на поле уже есть заполненные
+ * строки; игра в этом случае не меняется.
+ */
+bool undo_place_piece(UndoStack_t *stack, GameData_t *game,
+                      CurrentPiece_t piece) {
+  if (stack->depth >= UNDO_MAX_DEPTH || game->full_rows) return false;
+
+  UndoEntry_t *entry = &stack->entries[stack->depth++];
+  entry->piece = game->current_piece;
+  entry->info = game->info;
+  memcpy(entry->heights, game->heights, sizeof(entry->heights));
+  entry->hash = game->hash;
+
+  const PieceRotation_t *rotation = piece_rotation(&piece);
+  entry->cell_count = 0;
+  for (int i = 0; i < 4; i++) {
+    int y = piece.y + i;
+    for (int j = 0; j < 4; j++) {
+      int x = piece.x + j;
+      if ((rotation->rows[i] & (1u << j)) && y >= 0 && y < BOARD_HEIGHT &&
+          x >= 0 && x < BOARD_WIDTH) {
+        entry->cells[entry->cell_count++] =
+            (UndoCell_t){(int8_t)x, (int8_t)y, game->board[y][x]};
+      }
+    }
+  }
+
+  game->current_piece = piece;
+  imprint_piece_to_board(game);
+
+  entry->cleared = game->full_rows;
+  int saved = 0;
+  for (int y = 0; y < BOARD_HEIGHT && saved < UNDO_MAX_ROWS; y++) {
+    if ((entry->cleared >> y) & 1u) {
+      memcpy(entry->cleared_board[saved++], game->board[y], BOARD_WIDTH);
+    }
+  }
+  process_scoring_and_levelup(game);
+  return true;
+}
+
+/**
+ * @brief Возвращает строки, удаленные clear_lines, на прежние места.
+ *
+ * Обратный проход к уплотнению: сверху вниз каждая строка либо берется
+ * из журнала, либо поднимается из уплотненного поля. Строки ниже нижней
+ * очищенной не трогаются.
+ * @param entry Запись журнала.
+ * @param game Указатель на главную структуру данных игры.
+ */
+static void restore_cleared_rows(const UndoEntry_t *entry, GameData_t *game) {
+  int read = 0, bottom = 0;
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    if ((entry->cleared >> y) & 1u) {
+      read++;
+      bottom = y;
+    }
+  }
+
+  int saved = 0;
+  for (int y = 0; y <= bottom; y++) {
+    if ((entry->cleared >> y) & 1u) {
+      game->rows[y] = FULL_ROW_MASK;
+      memcpy(game->board[y], entry->cleared_board[saved++], BOARD_WIDTH);
+    } else {
+      game->rows[y] = game->rows[read];
+      memcpy(game->board[y], game->board[read], BOARD_WIDTH);
+      read++;
+    }
+  }
+}
+
+/**
+ * @brief Отменяет последнюю фиксацию фигуры из стека отмены.
+ *
+ * Стоимость пропорциональна числу измененных клеток и очищенных строк, а
+ * не размеру поля. Счетчик `board_version` не откатывается, а
+ * увеличивается: поле снова изменилось, и кэши, привязанные к версии,
+ * должны это увидеть.
+ * @param stack Стек отмены; при пустом стеке ничего не происходит.
+ * @param game Игра, в которой выполнялся undo_place_piece.
+ */
+void undo_restore(UndoStack_t *stack, GameData_t *game) {
+  if (stack->depth <= 0) return;
+  const UndoEntry_t *entry = &stack->entries[--stack->depth];
+
+  if (entry->cleared) restore_cleared_rows(entry, game);
+  for (int i = 0; i < entry->cell_count; i++) {
+    const UndoCell_t *cell = &entry->cells[i];
+    game->board[cell->y][cell->x] = cell->color;
+    if (cell->color)
+      game->rows[cell->y] |= (uint16_t)(1u << cell->x);
+    else
+      game->rows[cell->y] &= (uint16_t)~(1u << cell->x);
+  }
+
+  memcpy(game->heights, entry->heights, sizeof(game->heights));
+  game->full_rows = 0;
+  game->hash = entry->hash;
+  game->info = entry->info;
+  game->current_piece = entry->piece;
+  game->board_version++;
+}
@@ -0,0 +1,36 @@
+#ifndef BRICKGAME_TETRIS_UNDO_H
+#define BRICKGAME_TETRIS_UNDO_H
+
+#include "brickgame/tetris/tetris_core.h"
+
+#define UNDO_MAX_DEPTH 64
+#define UNDO_MAX_ROWS 4
+
+typedef struct {
+  int8_t x;
+  int8_t y;
+  uint8_t color;
+} UndoCell_t;
+
+typedef struct {
+  CurrentPiece_t piece;
+  GameInfo_t info;
+  uint8_t heights[BOARD_WIDTH];
+  uint64_t hash;
+  uint32_t cleared;
+  int8_t cell_count;
+  UndoCell_t cells[4];
+  uint8_t cleared_board[UNDO_MAX_ROWS][BOARD_WIDTH];
+} UndoEntry_t;
+
+typedef struct {
+  int depth;
+  UndoEntry_t entries[UNDO_MAX_DEPTH];
+} UndoStack_t;
+
+void undo_reset(UndoStack_t *stack);
+bool undo_place_piece(UndoStack_t *stack, GameData_t *game,
+                      CurrentPiece_t piece);
+void undo_restore(UndoStack_t *stack, GameData_t *game);
+
+#endif
@@ -1,21 +1,530 @@
 #include "main.h"
 
-int main() {
+#define DEFAULT_REPLAY_PATH "replay.bin"
+#define TICK_NS 40000000LL
+#define MAX_CATCH_UP_TICKS 25
+#define INPUT_BATCH 64
+#define REPEAT_GAP_NS 60000000LL
+#define NS_PER_MS 1000000LL
+#define DEFAULT_PREVIEW (FRAME_QUEUE + 1)
+#define MAX_AI_THREADS 4
+
+typedef struct {
+  int direction;
+  int last_direction;
+  long long first_key;
+  long long last_key;
+} ShiftKeys_t;
+
+typedef struct {
+  long plans;
+  long long total_ns;
+  long long max_ns;
+} PlanTimes_t;
+
+/**
+ * @brief Возвращает показания монотонных часов в наносекундах.
+ *
+ * @return long long Время от произвольной точки отсчета.
+ */
+static long long monotonic_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Проверяет, стоят ли игровые часы.
+ *
+ * На заставке, на паузе и после конца игры update_game_state ничего не
+ * меняет, поэтому цикл спит до нажатия клавиши.
+ * @param game Указатель на главную структуру данных игры.
+ * @return true Если тики не нужны.
+ */
+static bool is_idle(const GameData_t *game) {
+  return game->info.pause || game->state == Start ||
+         game->state == GameOver;
+}
+
+/**
+ * @brief Блокируется до ввода с клавиатуры или до наступления срока.
+ *
+ * @param deadline Момент пробуждения по monotonic_ns; отрицательное
+ * значение — ждать только ввода.
+ */
+static void wait_for_input(long long deadline) {
+  struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+  struct timespec timeout, *timeout_ptr = NULL;
+  if (deadline >= 0) {
+    long long left = deadline - monotonic_ns();
+    if (left < 0) left = 0;
+    timeout.tv_sec = (time_t)(left / 1000000000LL);
+    timeout.tv_nsec = (long)(left % 1000000000LL);
+    timeout_ptr = &timeout;
+  }
+  ppoll(&input, 1, timeout_ptr, NULL);
+}
+
+/**
+ * @brief Переводит показания monotonic_ns в отметку игровых часов.
+ *
+ * @param game Указатель на главную структуру данных игры.
+ * @param next_tick Момент выполнения следующего тика.
+ * @param at Переводимый момент.
+ * @return long Отметка в субтиках для press_shift и release_shift.
+ */
+static long shift_time(const GameData_t *game, long long next_tick,
+                       long long at) {
+  long long offset =
+      (at - (next_tick - TICK_NS)) * SUBTICKS_PER_TICK / TICK_NS;
+  if (offset > SUBTICKS_PER_TICK - 1) offset = SUBTICKS_PER_TICK - 1;
+  if (offset < -SUBTICKS_PER_TICK * MAX_CATCH_UP_TICKS)
+    offset = -SUBTICKS_PER_TICK * MAX_CATCH_UP_TICKS;
+  return game_subtick(game, (int)offset);
+}
+
+/**
+ * @brief Передает движку и записывает нажатие или отпускание сдвига.
+ *
+ * @param game Указатель на главную структуру данных игры.
+ * @param recorder Запись игры.
+ * @param tick Номер следующего тика.
+ * @param direction Направление сдвига.
+ * @param time Момент события в субтиках.
+ * @param released true — отпускание.
+ */
+static void send_shift(GameData_t *game, Recorder_t *recorder, long tick,
+                       int direction, long time, bool released) {
+  recorder_record_shift(recorder, tick, direction, time, released);
+  if (released)
+    release_shift(game, direction, time);
+  else
+    press_shift(game, direction, time);
+}
+
+/**
+ * @brief Обрабатывает нажатие клавиши горизонтального сдвига.
+ *
+ * Терминал не сообщает об отпускании клавиш, поэтому удержание
+ * распознается по автоповтору терминала: повторное нажатие того же
+ * направления не позже чем через REPEAT_GAP_NS после предыдущего. Одиночное
+ * нажатие передается движку как нажатие и отпускание в один момент (сдвиг
+ * на клетку). При удержании нажатие передается с моментом первого нажатия
+ * серии, так что задержка автоповтора отсчитывается от него, а дальше
+ * фигуру двигает движок с периодом arr; повторы терминала лишь продлевают
+ * удержание.
+ * @param keys Состояние клавиш сдвига.
+ * @param game Указатель на главную структуру данных игры.
+ * @param recorder Запись игры.
+ * @param tick Номер следующего тика.
+ * @param next_tick Момент выполнения следующего тика.
+ * @param direction Направление сдвига.
+ * @param stats Счетчики ввода; повторы удерживаемой клавиши считаются
+ * свернутыми.
+ * @return true Если событие передано движку.
+ */
+static bool handle_shift_key(ShiftKeys_t *keys, GameData_t *game,
+                             Recorder_t *recorder, long tick,
+                             long long next_tick, int direction,
+                             InputStats_t *stats) {
+  long long now = monotonic_ns();
+  stats->events++;
+  if (keys->direction == direction) {
+    keys->last_key = now;
+    stats->coalesced++;
+    return false;
+  }
+
+  long time = shift_time(game, next_tick, now);
+  if (keys->direction) {
+    send_shift(game, recorder, tick, keys->direction, time, true);
+    keys->direction = 0;
+  }
+  if (keys->last_direction == direction &&
+      now - keys->last_key <= REPEAT_GAP_NS) {
+    time = shift_time(game, next_tick, keys->first_key);
+    send_shift(game, recorder, tick, direction, time, false);
+    keys->direction = direction;
+  } else {
+    send_shift(game, recorder, tick, direction, time, false);
+    send_shift(game, recorder, tick, direction, time, true);
+    keys->first_key = now;
+  }
+  keys->last_direction = direction;
+  keys->last_key = now;
+  return true;
+}
+
+/**
+ * @brief Отпускает удерживаемый сдвиг, если повторы терминала прекратились.
+ *
+ * Вызывается до того, как догоняются наступившие тики: отпускание
+ * попадает в тот тик, на который пришелся срок ожидания повтора.
+ * @param keys Состояние клавиш сдвига.
+ * @param game Указатель на главную структуру данных игры.
+ * @param recorder Запись игры.
+ * @param tick Номер следующего тика.
+ * @param next_tick Момент выполнения следующего тика.
+ * @param now Текущий момент.
+ */
+static void release_stale_shift(ShiftKeys_t *keys, GameData_t *game,
+                                Recorder_t *recorder, long tick,
+                                long long next_tick, long long now) {
+  if (!keys->direction || now - keys->last_key <= REPEAT_GAP_NS) return;
+
+  long time = shift_time(game, next_tick, keys->last_key + REPEAT_GAP_NS);
+  send_shift(game, recorder, tick, keys->direction, time, true);
+  keys->direction = 0;
+}
+
+/**
+ * @brief Сворачивает, записывает и применяет пачку действий.
+ *
+ * @param game Указатель на главную структуру данных игры.
+ * @param recorder Запись игры.
+ * @param tick Номер следующего тика.
+ * @param actions Пачка действий.
+ * @param count Количество действий.
+ * @param stats Счетчики ввода.
+ * @return true Если после сворачивания осталось хотя бы одно действие.
+ */
+static bool apply_batch(GameData_t *game, Recorder_t *recorder, long tick,
+                        const UserAction_t *actions, int count,
+                        InputStats_t *stats) {
+  UserAction_t coalesced[INPUT_BATCH];
+  int length = coalesce_actions(game, actions, count, coalesced, stats);
+  for (int i = 0; i < length; i++) {
+    recorder_record(recorder, tick, coalesced[i]);
+    apply_user_action(game, coalesced[i]);
+  }
+  return length > 0;
+}
+
+/**
+ * @brief Вычитывает все накопившиеся нажатия и применяет их сразу.
+ *
+ * За одно пробуждение читается весь буфер терминала, так что нажатия не
+ * копятся и не применяются с опозданием. Пачка сворачивается
+ * coalesce_actions: в запись попадают уже свернутые действия, поэтому
+ * повтор дает ту же игру. Горизонтальные сдвиги в пачку не попадают: их
+ * обрабатывает handle_shift_key, а пачка перед ними применяется, чтобы
+ * сохранить порядок нажатий. Нажатия записываются с номером тика, который
+ * выполнится следующим, поэтому при повторе они применяются до того же
+ * update_game_state.
+ * @param renderer Вывод, с терминала которого читаются нажатия.
+ * @param keys Состояние клавиш сдвига.
+ * @param game Указатель на главную структуру данных игры.
+ * @param recorder Запись игры.
+ * @param tick Номер следующего тика.
+ * @param next_tick Момент выполнения следующего тика.
+ * @param stats Счетчики ввода; неназначенные клавиши считаются
+ * отброшенными.
+ * @return true Если было применено хотя бы одно действие.
+ */
+static bool handle_input(Renderer_t *renderer, ShiftKeys_t *keys,
+                         GameData_t *game, Recorder_t *recorder, long tick,
+                         long long next_tick, InputStats_t *stats) {
+  UserAction_t actions[INPUT_BATCH];
+  int count = 0;
+  bool changed = false;
+  int key;
+  while ((key = renderer->read_key(renderer)) != ERR) {
+    UserAction_t action = get_user_action(key);
+    if (action == ActionNone) {
+      stats->events++;
+      stats->dropped++;
+      continue;
+    }
+    if (action == ActionMoveLeft || action == ActionMoveRight) {
+      changed |= apply_batch(game, recorder, tick, actions, count, stats);
+      count = 0;
+      changed |= handle_shift_key(keys, game, recorder, tick, next_tick,
+                                  action == ActionMoveLeft ? -1 : 1, stats);
+      continue;
+    }
+    actions[count++] = action;
+    if (count == INPUT_BATCH) {
+      changed |= apply_batch(game, recorder, tick, actions, count, stats);
+      count = 0;
+    }
+  }
+  changed |= apply_batch(game, recorder, tick, actions, count, stats);
+  return changed;
+}
+
+/**
+ * @brief Выполняет задачи автоигрока на пуле потоков с кражей работы.
+ *
+ * Пул создается один раз на всю игру; если его создать или запустить не
+ * удалось, задачи выполняются в вызывающем потоке.
+ * @param runner Пул потоков (WorkerPool_t) или NULL.
+ * @param threads Количество потоков.
+ * @param task_count Количество задач.
+ * @param fn Функция, выполняющая одну задачу.
+ * @param context Контекст, передаваемый в fn.
+ */
+static void run_ai_tasks(void *runner, int threads, int64_t task_count,
+                         AiTaskFn_t fn, void *context) {
+  (void)threads;
+  if (runner == NULL || pool_run(runner, task_count, fn, context, NULL) != 0) {
+    for (int64_t task = 0; task < task_count; task++) fn(context, 0, task);
+  }
+}
+
+/**
+ * @brief Останавливает пул потоков автоигрока и освобождает его.
+ *
+ * @param ai Автоигрок (NULL допускается).
+ */
+static void destroy_ai(AiPlayer_t *ai) {
+  if (ai == NULL) return;
+  pool_destroy(ai->runner);
+  ai_destroy(ai);
+}
+
+/**
+ * @brief Применяет и записывает ходы автоигрока до ближайшего ожидания.
+ *
+ * Действия автоигрока проходят тот же путь, что и нажатия клавиш: они
+ * записываются с номером следующего тика, а сдвиги передаются как
+ * одиночные нажатия (send_shift), поэтому запись игры воспроизводится как
+ * обычно.
+ * @param ai Автоигрок.
+ * @param game Указатель на главную структуру данных игры.
+ * @param recorder Запись игры.
+ * @param tick Номер следующего тика.
+ * @param times Время, затраченное на планирование ходов.
+ * @return true Если было применено хотя бы одно действие.
+ */
+static bool play_ai(AiPlayer_t *ai, GameData_t *game, Recorder_t *recorder,
+                    long tick, PlanTimes_t *times) {
+  long long started = monotonic_ns();
+  long plans = ai->plans;
+  bool changed = false;
+  UserAction_t action;
+  while ((action = ai_next_action(ai, game)) != ActionNone) {
+    if (action == ActionMoveLeft || action == ActionMoveRight) {
+      // Сдвиг на клетку — нажатие и отпускание в один момент
+      int direction = action == ActionMoveLeft ? -1 : 1;
+      long time = game_subtick(game, 0);
+      send_shift(game, recorder, tick, direction, time, false);
+      send_shift(game, recorder, tick, direction, time, true);
+    } else {
+      recorder_record(recorder, tick, action);
+      apply_user_action(game, action);
+    }
+    changed = true;
+  }
+  if (ai->plans != plans) {
+    long long spent = monotonic_ns() - started;
+    times->plans += ai->plans - plans;
+    times->total_ns += spent;
+    if (spent > times->max_ns) times->max_ns = spent;
+  }
+  return changed;
+}
+
+static void print_plan_times(const PlanTimes_t *times) {
+  double mean = times->plans ? times->total_ns / 1e3 / times->plans : 0.0;
+  printf("AI: %ld plans, mean %.1f us, max %.1f us\n", times->plans, mean,
+         times->max_ns / 1e3);
+}
+
+/**
+ * @brief Играет автоигроком без вывода и без ожидания.
+ *
+ * Игра идет по игровым часам: после ходов автоигрока часы сразу
+ * переводятся к следующему событию движка, как в симуляторе.
+ * @param ai Автоигрок.
+ * @param game Указатель на главную структуру данных игры.
+ * @param recorder Запись игры.
+ * @param max_pieces Предельное число фигур; 0 — до конца игры.
+ * @param times Время, затраченное на планирование ходов.
+ * @return long Число выполненных тиков.
+ */
+static long run_headless(AiPlayer_t *ai, GameData_t *game,
+                         Recorder_t *recorder, long max_pieces,
+                         PlanTimes_t *times) {
+  long tick = 0;
+  while (game->state != GameOver &&
+         (max_pieces <= 0 || game->piece_count <= max_pieces)) {
+    play_ai(ai, game, recorder, tick, times);
+    long due = next_event_tick(game) - game->timer.tick + 1;
+    advance_game(game, due);
+    tick += due;
+  }
+  return tick;
+}
+
+int main(int argc, char **argv) {
+  const char *replay_path = DEFAULT_REPLAY_PATH;
+  size_t byte_budget = 0;
+  bool ansi = false;
+  long das_ms = DEFAULT_DAS * TICK_NS / SUBTICKS_PER_TICK / NS_PER_MS;
+  long arr_ms = DEFAULT_ARR * TICK_NS / SUBTICKS_PER_TICK / NS_PER_MS;
+  int previews = DEFAULT_PREVIEW;
+  bool autoplay = false, headless = false;
+  int beam_width = AI_DEFAULT_WIDTH, plies = AI_DEFAULT_DEPTH;
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  int threads = cpus < 1 ? 1 : cpus > MAX_AI_THREADS ? MAX_AI_THREADS
+                                                       : (int)cpus;
+  long max_pieces = 0;
+  int option;
+  while ((option = getopt(argc, argv, "r:ab:D:R:N:AHW:P:T:M:")) != -1) {
+    if (option == 'r') {
+      replay_path = optarg;
+    } else if (option == 'a') {
+      ansi = true;
+    } else if (option == 'b') {
+      byte_budget = strtoul(optarg, NULL, 10);
+    } else if (option == 'D') {
+      das_ms = strtol(optarg, NULL, 10);
+    } else if (option == 'R') {
+      arr_ms = strtol(optarg, NULL, 10);
+    } else if (option == 'N') {
+      previews = (int)strtol(optarg, NULL, 10);
+    } else if (option == 'A') {
+      autoplay = true;
+    } else if (option == 'H') {
+      autoplay = headless = true;
+    } else if (option == 'W') {
+      beam_width = (int)strtol(optarg, NULL, 10);
+    } else if (option == 'P') {
+      plies = (int)strtol(optarg, NULL, 10);
+    } else if (option == 'T') {
+      threads = (int)strtol(optarg, NULL, 10);
+    } else if (option == 'M') {
+      max_pieces = strtol(optarg, NULL, 10);
+    } else {
+      fprintf(stderr,
+              "Usage: %s [-r replay_file] [-a] [-b frame_bytes] "
+              "[-D das_ms] [-R arr_ms] [-N previews] [-A] [-H] "
+              "[-W beam_width] [-P plies] [-T threads] [-M max_pieces]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+
   GameData_t game;
+  uint64_t seed = (uint64_t)time(NULL);
+  initialize_game_seeded(&game, seed);
+  set_settle_transitions(&game, true);
+  // Автоигрок видит в поиске только фигуры из очереди предпросмотра
+  if (autoplay && previews < plies - 1) previews = plies - 1;
+  set_preview_length(&game, previews);
+  set_auto_shift(&game,
+                 (int)(das_ms * NS_PER_MS * SUBTICKS_PER_TICK / TICK_NS),
+                 (int)(arr_ms * NS_PER_MS * SUBTICKS_PER_TICK / TICK_NS));
 
-  initialize_game(&game);
-  init_terminal();
+  // Запись не обязательна: без файла игра продолжается как обычно
+  Recorder_t recorder;
+  ReplayHeader_t header = {REPLAY_VERSION,
+                           REPLAY_FLAG_SETTLE | REPLAY_FLAG_AUTO_SHIFT,
+                           seed,
+                           game.info.high_score,
+                           game.auto_shift.das,
+                           game.auto_shift.arr};
+  recorder_open(&recorder, replay_path, &header);
+
+  AiPlayer_t *ai = NULL;
+  PlanTimes_t plan_times = {0, 0, 0};
+  if (autoplay) {
+    ai = ai_create(beam_width, plies, threads);
+    if (ai == NULL) {
+      fprintf(stderr, "Out of memory\n");
+      recorder_close(&recorder, 0);
+      return 1;
+    }
+    ai->parallel = run_ai_tasks;
+    // Потоки поиска живут всю игру и спят между ходами; без пула поиск
+    // идет в вызывающем потоке
+    if (ai->threads > 1) ai->runner = pool_create(ai->threads);
+  }
 
+  if (headless) {
+    long long started = monotonic_ns();
+    long ticks = run_headless(ai, &game, &recorder, max_pieces, &plan_times);
+    double elapsed = (double)(monotonic_ns() - started) / 1e9;
+    recorder_close(&recorder, ticks);
+    printf("Pieces: %ld, ticks: %ld, elapsed: %.3f s\n", game.piece_count,
+           ticks, elapsed);
+    print_plan_times(&plan_times);
+    printf("Score: %d, level: %d\n", game.info.score, game.info.level);
+    destroy_ai(ai);
+    return 0;
+  }
+
+  Renderer_t renderer;
+  if (ansi)
+    ansi_view_renderer(&renderer, STDOUT_FILENO, byte_budget);
+  else
+    ncurses_renderer(&renderer, NULL);
+  if (!renderer.init(&renderer)) {
+    fprintf(stderr, "Failed to initialize the %s terminal\n", renderer.name);
+    recorder_close(&recorder, 0);
+    destroy_ai(ai);
+    return 1;
+  }
+  renderer.draw(&renderer, &game);
+
+  // Цикл просыпается только по нажатию или к тику следующего события
+  // движка (next_event_tick); пустые тики между ними пропускаются.
+  long tick = 0;
+  InputStats_t input = {0, 0, 0};
+  ShiftKeys_t keys = {0, 0, 0, 0};
+  long long next_tick = monotonic_ns() + TICK_NS;
   while (game.state != GameOver) {
-    UserAction_t action = get_user_action(getch());
-    apply_user_action(&game, action);
-    update_game_state(&game);
-    draw_game(&game);
-    usleep(40000);
+    if (ai && play_ai(ai, &game, &recorder, tick, &plan_times))
+      renderer.draw(&renderer, &game);
+
+    long long deadline = -1;
+    if (!is_idle(&game)) {
+      long ahead = next_event_tick(&game) - game.timer.tick;
+      deadline = next_tick + ahead * TICK_NS;
+    }
+    if (keys.direction &&
+        (deadline < 0 || keys.last_key + REPEAT_GAP_NS < deadline))
+      deadline = keys.last_key + REPEAT_GAP_NS;
+    wait_for_input(deadline);
+
+    // Сначала догоняются тики, наступившие до нажатия, затем применяется
+    // ввод — с тем же номером тика, что получит и повтор записи.
+    bool changed = false;
+    long long now = monotonic_ns();
+    release_stale_shift(&keys, &game, &recorder, tick, next_tick, now);
+    if (!is_idle(&game) && now >= next_tick) {
+      long due = (long)((now - next_tick) / TICK_NS) + 1;
+      long ahead = next_event_tick(&game) - game.timer.tick;
+      if (due > ahead + MAX_CATCH_UP_TICKS) due = ahead + MAX_CATCH_UP_TICKS;
+      advance_game(&game, due);
+      tick += due;
+      next_tick += due * TICK_NS;
+      if (now >= next_tick) next_tick = now + TICK_NS;
+      changed = true;
+    }
+
+    bool was_idle = is_idle(&game);
+    changed |= handle_input(&renderer, &keys, &game, &recorder, tick,
+                            next_tick, &input);
+    if (was_idle) next_tick = now + TICK_NS;
+
+    if (changed) renderer.draw(&renderer, &game);
   }
 
-  cleanup_terminal();
+  renderer.cleanup(&renderer);
+  if (renderer.bytes > 0) {
+    printf("Frames: %ld, bytes: %zu\n", renderer.frames, renderer.bytes);
+  }
+  printf("Ghost: %ld recomputes in %ld frames\n", renderer.ghost.recomputes,
+         renderer.frames);
+  recorder_close(&recorder, tick);
   save_high_score(game.info.high_score);
+  printf("Input: %ld events, %ld coalesced, %ld dropped\n", input.events,
+         input.coalesced, input.dropped);
+  if (ai) {
+    print_plan_times(&plan_times);
+    destroy_ai(ai);
+  }
   printf("Game Over! Your score: %d\n", game.info.score);
   printf("High Score: %d\n", game.info.high_score);
 
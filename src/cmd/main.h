@@ -1,6 +1,12 @@
-#define _DEFAULT_SOURCE
+#define _GNU_SOURCE
+#include <poll.h>
 #include <stdio.h>
+#include <time.h>
 #include <unistd.h>
 
+#include "brickgame/tetris/ai.h"
+#include "brickgame/tetris/recorder.h"
 #include "brickgame/tetris/tetris.h"
+#include "cmd/scheduler.h"
+#include "gui/cli/ansi_view.h"
 #include "gui/cli/view.h"
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "perft.h"
+
+#define DEFAULT_DEPTH 3
+
+typedef struct {
+  GameData_t root;
+  MoveGen_t *root_gen;
+  MoveGen_t **worker_gens;
+  TTable_t **worker_tables;
+  const int *queue;
+  int depth;
+  uint64_t *subtree_nodes;
+} PerftContext_t;
+
+/**
+ * @brief Задача планировщика: считает поддерево одного корневого хода.
+ *
+ * @param context Указатель на PerftContext_t.
+ * @param worker Номер потока; у каждого потока свои рабочие области и
+ * своя таблица транспозиций.
+ * @param task Номер положения первой фигуры.
+ */
+static void count_subtree(void *context, int worker, int64_t task) {
+  PerftContext_t *perft_context = context;
+  GameData_t child = perft_context->root;
+  play_placement(&child, perft_context->root_gen, (int)task);
+  TTable_t *table = perft_context->worker_tables
+                        ? perft_context->worker_tables[worker]
+                        : NULL;
+  perft_context->subtree_nodes[task] =
+      perft_cached(perft_context->worker_gens[worker], table, &child,
+                   perft_context->queue + 1, perft_context->depth - 1);
+}
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void print_usage(const char *name) {
+  fprintf(stderr,
+          "Usage: %s [-d depth] [-s seed] [-t threads] [-H table_mb] [-b]\n",
+          name);
+}
+
+/**
+ * @brief Освобождает рабочие области и таблицы транспозиций подсчета.
+ *
+ * Допускает частично выделенный контекст: отсутствующие массивы и
+ * элементы пропускаются.
+ * @param context Контекст подсчета.
+ * @param threads Число потоков, под которое выделялись рабочие области.
+ */
+static void free_context(PerftContext_t *context, int threads) {
+  for (int i = 0; context->worker_gens && i < threads; i++) {
+    free(context->worker_gens[i]);
+  }
+  free(context->worker_gens);
+  for (int i = 0; context->worker_tables && i < threads; i++) {
+    ttable_destroy(context->worker_tables[i]);
+  }
+  free(context->worker_tables);
+  free(context->root_gen);
+  free(context->subtree_nodes);
+}
+
+/**
+ * @brief Выводит результат подсчета и статистику таблиц транспозиций.
+ *
+ * @param context Контекст подсчета.
+ * @param seed Начальное значение генератора.
+ * @param bag7 Использовалась ли генерация мешками.
+ * @param threads Число потоков.
+ * @param table_mb Размер таблицы транспозиций на поток в мегабайтах.
+ * @param nodes Число узлов.
+ * @param elapsed Время подсчета в секундах.
+ */
+static void print_report(const PerftContext_t *context, uint64_t seed,
+                         bool bag7, int threads, long table_mb,
+                         uint64_t nodes, double elapsed) {
+  int depth = context->depth;
+  const int *queue = context->queue;
+  printf("seed:        %llu\n", (unsigned long long)seed);
+  printf("randomizer:  %s\n", bag7 ? "bag7" : "uniform");
+  printf("queue:      ");
+  for (int i = 0; i < depth; i++) printf(" %c", "IOTLJSZ"[queue[i]]);
+  printf("\n");
+  printf("depth:       %d\n", depth);
+  printf("threads:     %d\n", threads);
+  printf("nodes:       %llu\n", (unsigned long long)nodes);
+  printf("elapsed:     %.3f s\n", elapsed);
+  printf("nodes/s:     %.1f\n", elapsed > 0 ? (double)nodes / elapsed : 0.0);
+  if (context->worker_tables) {
+    long probes = 0, hits = 0;
+    for (int i = 0; i < threads; i++) {
+      probes += context->worker_tables[i]->probes;
+      hits += context->worker_tables[i]->hits;
+    }
+    printf("table:       %ld MB x %d, %ld hits / %ld probes\n", table_mb,
+           threads, hits, probes);
+  }
+}
+
+int main(int argc, char **argv) {
+  int depth = DEFAULT_DEPTH;
+  int threads = 1;
+  uint64_t seed = 1;
+  bool bag7 = false;
+  long table_mb = 0;
+
+  int option;
+  while ((option = getopt(argc, argv, "d:s:t:H:bh")) != -1) {
+    switch (option) {
+      case 'd':
+        depth = (int)strtol(optarg, NULL, 10);
+        break;
+      case 's':
+        seed = strtoull(optarg, NULL, 10);
+        break;
+      case 't':
+        threads = (int)strtol(optarg, NULL, 10);
+        break;
+      case 'H':
+        table_mb = strtol(optarg, NULL, 10);
+        break;
+      case 'b':
+        bag7 = true;
+        break;
+      default:
+        print_usage(argv[0]);
+        return option == 'h' ? 0 : 1;
+    }
+  }
+  if (depth < 1 || depth > PERFT_MAX_DEPTH || threads < 1 || table_mb < 0) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  PerftContext_t context = {.depth = depth};
+  initialize_game_core(&context.root, 0, seed);
+  if (bag7) set_randomizer(&context.root, RandomizerBag7);
+  int queue[PERFT_MAX_DEPTH];
+  perft_queue(&context.root, queue, depth);
+  context.queue = queue;
+
+  context.root_gen = malloc(sizeof(MoveGen_t));
+  context.worker_gens = calloc((size_t)threads, sizeof(MoveGen_t *));
+  WorkerStats_t *stats = calloc((size_t)threads, sizeof(WorkerStats_t));
+  bool allocated = context.root_gen && context.worker_gens && stats;
+  for (int i = 0; allocated && i < threads; i++) {
+    context.worker_gens[i] = malloc(sizeof(MoveGen_t) * (size_t)depth);
+    allocated = context.worker_gens[i] != NULL;
+  }
+  if (allocated && table_mb > 0) {
+    context.worker_tables = calloc((size_t)threads, sizeof(TTable_t *));
+    allocated = context.worker_tables != NULL;
+    for (int i = 0; allocated && i < threads; i++) {
+      context.worker_tables[i] = ttable_create((size_t)table_mb << 20);
+      allocated = context.worker_tables[i] != NULL;
+    }
+  }
+  int status = 1;
+  if (!allocated) {
+    fprintf(stderr, "Out of memory\n");
+  } else {
+    double started = now_seconds();
+    int root_count =
+        generate_spawn_placements(context.root_gen, &context.root, queue[0]);
+    uint64_t nodes = (uint64_t)root_count;
+    if (depth > 1 && root_count > 0) {
+      context.subtree_nodes = calloc((size_t)root_count, sizeof(uint64_t));
+      // run_work_stealing обходится меньшим числом потоков, если часть не
+      // создалась, и возвращает ошибку только при нехватке памяти
+      if (!context.subtree_nodes ||
+          run_work_stealing(threads, root_count, count_subtree, &context,
+                            stats) != 0) {
+        fprintf(stderr, "Out of memory\n");
+      } else {
+        nodes = 0;
+        for (int i = 0; i < root_count; i++) nodes += context.subtree_nodes[i];
+        status = 0;
+      }
+    } else {
+      status = 0;
+    }
+    if (status == 0) {
+      print_report(&context, seed, bag7, threads, table_mb, nodes,
+                   now_seconds() - started);
+    }
+  }
+
+  free_context(&context, threads);
+  free(stats);
+  return status;
+}
@@ -0,0 +1,8 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "brickgame/tetris/perft.h"
+#include "cmd/scheduler.h"
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "replay.h"
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void print_usage(const char *name) {
+  fprintf(stderr, "Usage: %s [-e expected_score] replay_file\n", name);
+}
+
+int main(int argc, char **argv) {
+  long expected_score = -1;
+  int option;
+  while ((option = getopt(argc, argv, "e:h")) != -1) {
+    if (option != 'e') {
+      print_usage(argv[0]);
+      return option == 'h' ? 0 : 1;
+    }
+    expected_score = strtol(optarg, NULL, 10);
+  }
+  if (optind != argc - 1) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  ReplayReader_t reader;
+  if (!replay_open(&reader, argv[optind])) {
+    fprintf(stderr, "Cannot read replay %s\n", argv[optind]);
+    return 1;
+  }
+  ReplayHeader_t header = reader.header;
+  replay_close(&reader);
+
+  GameData_t game;
+  double started = now_seconds();
+  long ticks = replay_run(argv[optind], &game);
+  double elapsed = now_seconds() - started;
+  if (ticks < 0) {
+    fprintf(stderr, "Cannot read replay %s\n", argv[optind]);
+    return 1;
+  }
+
+  printf("version:     %d\n", header.version);
+  printf("seed:        %llu\n", (unsigned long long)header.seed);
+  if (header.flags & REPLAY_FLAG_AUTO_SHIFT) {
+    printf("auto shift:  das %d, arr %d subticks\n", header.das, header.arr);
+  }
+  printf("ticks:       %ld\n", ticks);
+  printf("game over:   %s\n", game.state == GameOver ? "yes" : "no");
+  printf("score:       %d\n", game.info.score);
+  printf("level:       %d\n", game.info.level);
+  printf("high score:  %d\n", game.info.high_score);
+  printf("elapsed:     %.3f s\n", elapsed);
+  printf("ticks/s:     %.1f\n", elapsed > 0 ? (double)ticks / elapsed : 0.0);
+
+  if (expected_score >= 0 && game.info.score != expected_score) {
+    fprintf(stderr, "Score mismatch: expected %ld, replayed %d\n",
+            expected_score, game.info.score);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,7 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "brickgame/tetris/recorder.h"
\ No newline at end of file
@@ -0,0 +1,372 @@
+#include "cmd/scheduler.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "brickgame/tetris/tetris_core.h"
+
+/**
+ * @brief Создает двустороннюю очередь задач Чейза-Лева.
+ *
+ * Владелец очереди кладет и забирает задачи с "низа", остальные потоки
+ * крадут их с "верха" без блокировок.
+ * @param deque Инициализируемая очередь.
+ * @param capacity Максимальное число одновременно хранимых задач.
+ * @return true При успехе, false при ошибке выделения памяти.
+ */
+bool deque_init(WorkDeque_t *deque, int64_t capacity) {
+  int64_t size = 1;
+  while (size < capacity) size <<= 1;
+  deque->buffer = calloc((size_t)size, sizeof(*deque->buffer));
+  if (deque->buffer == NULL) return false;
+  deque->mask = size - 1;
+  atomic_init(&deque->top, 0);
+  atomic_init(&deque->bottom, 0);
+  return true;
+}
+
+/**
+ * @brief Освобождает буфер очереди задач.
+ *
+ * @param deque Очередь задач.
+ */
+void deque_free(WorkDeque_t *deque) {
+  free(deque->buffer);
+  deque->buffer = NULL;
+}
+
+/**
+ * @brief Кладет задачу в "низ" очереди. Вызывается только владельцем.
+ *
+ * @param deque Очередь задач.
+ * @param task Идентификатор задачи.
+ * @return true При успехе, false если очередь заполнена.
+ */
+bool deque_push(WorkDeque_t *deque, int64_t task) {
+  int64_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+  int64_t t = atomic_load_explicit(&deque->top, memory_order_acquire);
+  if (b - t > deque->mask) return false;
+  atomic_store_explicit(&deque->buffer[b & deque->mask], task,
+                        memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+  return true;
+}
+
+/**
+ * @brief Забирает задачу с "низа" очереди. Вызывается только владельцем.
+ *
+ * @param deque Очередь задач.
+ * @param task Куда записать идентификатор задачи.
+ * @return true Если задача получена, false если очередь пуста.
+ */
+bool deque_pop(WorkDeque_t *deque, int64_t *task) {
+  int64_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+  atomic_store_explicit(&deque->bottom, b, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  int64_t t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+  bool found = false;
+  if (t <= b) {
+    *task = atomic_load_explicit(&deque->buffer[b & deque->mask],
+                                 memory_order_relaxed);
+    found = true;
+    if (t == b) {
+      // Последняя задача: соревнуемся с ворами за нее
+      found = atomic_compare_exchange_strong_explicit(
+          &deque->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+      atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    }
+  } else {
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+  }
+  return found;
+}
+
+/**
+ * @brief Крадет задачу с "верха" чужой очереди.
+ *
+ * @param deque Очередь задач другого потока.
+ * @param task Куда записать идентификатор задачи.
+ * @return true Если задача украдена, false если очередь пуста или кражу
+ * перехватил другой поток.
+ */
+bool deque_steal(WorkDeque_t *deque, int64_t *task) {
+  int64_t t = atomic_load_explicit(&deque->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  int64_t b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+  if (t >= b) return false;
+
+  *task = atomic_load_explicit(&deque->buffer[t & deque->mask],
+                               memory_order_relaxed);
+  return atomic_compare_exchange_strong_explicit(
+      &deque->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+}
+
+/**
+ * @brief Возвращает число задач, оставшихся в очереди.
+ *
+ * @param deque Очередь задач.
+ * @return int64_t Число задач (не больше нуля, если очередь пуста).
+ */
+static int64_t deque_size(WorkDeque_t *deque) {
+  int64_t t = atomic_load_explicit(&deque->top, memory_order_acquire);
+  int64_t b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+  return b - t;
+}
+
+typedef struct {
+  WorkerPool_t *pool;
+  int id;
+  Rng_t rng;
+} Worker_t;
+
+struct WorkerPool {
+  int threads;
+  Worker_t *workers;
+  pthread_t *handles;
+  WorkDeque_t *deques;
+  WorkerStats_t *stats;
+  int64_t capacity;
+
+  TaskFn_t fn;
+  void *context;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_cond_t done;
+  long generation;
+  int busy;
+  bool stop;
+};
+
+/**
+ * @brief Находит следующую задачу для потока: своя очередь, затем кража.
+ *
+ * Во время прогона новые задачи не появляются, поэтому если после
+ * случайных попыток кражи все очереди пусты, работа разобрана и поток
+ * может уснуть до следующего прогона.
+ * @param pool Пул потоков.
+ * @param worker Поток, ищущий задачу.
+ * @param task Куда записать идентификатор задачи.
+ * @return true Если задача получена, false если задач не осталось.
+ */
+static bool grab_task(WorkerPool_t *pool, Worker_t *worker, int64_t *task) {
+  if (deque_pop(&pool->deques[worker->id], task)) return true;
+
+  WorkerStats_t *stats = &pool->stats[worker->id];
+  for (int attempt = 0; attempt < pool->threads; attempt++) {
+    int victim = (int)rng_below(&worker->rng, (uint32_t)pool->threads);
+    if (victim != worker->id && deque_steal(&pool->deques[victim], task)) {
+      stats->steals++;
+      return true;
+    }
+  }
+  // Кража могла сорваться из-за гонки с другим вором: обходим очереди по
+  // порядку, пока в них что-то есть
+  for (int victim = 0; victim < pool->threads; victim++) {
+    WorkDeque_t *deque = &pool->deques[victim];
+    while (deque_size(deque) > 0) {
+      if (deque_steal(deque, task)) {
+        if (victim != worker->id) stats->steals++;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Выполняет задачи текущего прогона, пока они не кончатся.
+ *
+ * @param pool Пул потоков.
+ * @param worker Выполняющий поток.
+ */
+static void run_tasks(WorkerPool_t *pool, Worker_t *worker) {
+  int64_t task;
+  while (grab_task(pool, worker, &task)) {
+    pool->fn(pool->context, worker->id, task);
+    pool->stats[worker->id].tasks_run++;
+  }
+}
+
+static void *worker_main(void *arg) {
+  Worker_t *worker = arg;
+  WorkerPool_t *pool = worker->pool;
+  long seen = 0;
+
+  pthread_mutex_lock(&pool->lock);
+  while (true) {
+    // Между прогонами поток спит на условной переменной, а не крутится
+    while (!pool->stop && pool->generation == seen) {
+      pthread_cond_wait(&pool->wake, &pool->lock);
+    }
+    if (pool->stop) break;
+    seen = pool->generation;
+    pthread_mutex_unlock(&pool->lock);
+
+    run_tasks(pool, worker);
+
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->busy == 0) pthread_cond_signal(&pool->done);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+/**
+ * @brief Создает пул потоков с кражей работы.
+ *
+ * Потоки запускаются один раз и спят между прогонами pool_run. Нулевой
+ * поток — вызывающий, поэтому запускается threads - 1 потоков. Если часть
+ * потоков не создалась, пул работает на тех, что запустились.
+ * @param threads Количество рабочих потоков (не меньше 1).
+ * @return WorkerPool_t* Пул или NULL при ошибке выделения памяти.
+ */
+WorkerPool_t *pool_create(int threads) {
+  if (threads < 1) threads = 1;
+  WorkerPool_t *pool = calloc(1, sizeof(WorkerPool_t));
+  if (pool == NULL) return NULL;
+
+  pool->workers = calloc((size_t)threads, sizeof(Worker_t));
+  pool->handles = calloc((size_t)threads, sizeof(pthread_t));
+  pool->deques = calloc((size_t)threads, sizeof(WorkDeque_t));
+  pool->stats = calloc((size_t)threads, sizeof(WorkerStats_t));
+  if (!pool->workers || !pool->handles || !pool->deques || !pool->stats) {
+    free(pool->workers);
+    free(pool->handles);
+    free(pool->deques);
+    free(pool->stats);
+    free(pool);
+    return NULL;
+  }
+
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->wake, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  for (int i = 0; i < threads; i++) {
+    pool->workers[i].pool = pool;
+    pool->workers[i].id = i;
+    rng_seed(&pool->workers[i].rng, (uint64_t)i);
+  }
+  pool->threads = 1;
+  while (pool->threads < threads &&
+         pthread_create(&pool->handles[pool->threads], NULL, worker_main,
+                        &pool->workers[pool->threads]) == 0) {
+    pool->threads++;
+  }
+  return pool;
+}
+
+/**
+ * @brief Увеличивает очереди пула так, чтобы в каждую вошло capacity задач.
+ *
+ * Вызывается, только пока рабочие потоки спят.
+ * @param pool Пул потоков.
+ * @param capacity Требуемая емкость очереди.
+ * @return true При успехе, false при ошибке выделения памяти.
+ */
+static bool pool_reserve(WorkerPool_t *pool, int64_t capacity) {
+  if (capacity <= pool->capacity) return true;
+  bool ok = true;
+  for (int i = 0; i < pool->threads; i++) {
+    deque_free(&pool->deques[i]);
+    if (ok) ok = deque_init(&pool->deques[i], capacity);
+  }
+  pool->capacity = ok ? capacity : 0;
+  return ok;
+}
+
+/**
+ * @brief Выполняет задачи 0..task_count-1 на пуле потоков с кражей работы.
+ *
+ * Задачи заранее раскладываются по очередям потоков непрерывными блоками;
+ * поток, опустошивший свою очередь, крадет задачи у случайных соседей.
+ * Нулевой поток выполняется в вызывающем потоке. Функция возвращается,
+ * когда все задачи выполнены, а рабочие потоки снова уснули.
+ * @param pool Пул потоков.
+ * @param task_count Количество задач.
+ * @param fn Функция, выполняющая одну задачу.
+ * @param context Контекст, передаваемый в fn.
+ * @param stats Массив из потоков пула для статистики потоков или NULL.
+ * @return int 0 при успехе, -1 при ошибке выделения памяти.
+ */
+int pool_run(WorkerPool_t *pool, int64_t task_count, TaskFn_t fn,
+             void *context, WorkerStats_t *stats) {
+  int64_t block = (task_count + pool->threads - 1) / pool->threads;
+  if (!pool_reserve(pool, block)) return -1;
+  for (int i = 0; i < pool->threads; i++) {
+    atomic_store_explicit(&pool->deques[i].top, 0, memory_order_relaxed);
+    atomic_store_explicit(&pool->deques[i].bottom, 0, memory_order_relaxed);
+    pool->stats[i] = (WorkerStats_t){0, 0};
+  }
+  for (int64_t task = 0; task < task_count; task++) {
+    deque_push(&pool->deques[task / block], task);
+  }
+
+  // Мьютекс публикует очереди и задачу для разбуженных потоков
+  pthread_mutex_lock(&pool->lock);
+  pool->fn = fn;
+  pool->context = context;
+  pool->busy = pool->threads - 1;
+  pool->generation++;
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->lock);
+
+  run_tasks(pool, &pool->workers[0]);
+
+  pthread_mutex_lock(&pool->lock);
+  while (pool->busy > 0) pthread_cond_wait(&pool->done, &pool->lock);
+  pthread_mutex_unlock(&pool->lock);
+
+  if (stats) {
+    for (int i = 0; i < pool->threads; i++) stats[i] = pool->stats[i];
+  }
+  return 0;
+}
+
+/**
+ * @brief Останавливает потоки пула и освобождает его.
+ *
+ * @param pool Пул потоков (NULL допускается).
+ */
+void pool_destroy(WorkerPool_t *pool) {
+  if (pool == NULL) return;
+  pthread_mutex_lock(&pool->lock);
+  pool->stop = true;
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->lock);
+  for (int i = 1; i < pool->threads; i++) pthread_join(pool->handles[i], NULL);
+
+  for (int i = 0; i < pool->threads; i++) deque_free(&pool->deques[i]);
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->wake);
+  pthread_cond_destroy(&pool->done);
+  free(pool->workers);
+  free(pool->handles);
+  free(pool->deques);
+  free(pool->stats);
+  free(pool);
+}
+
+/**
+ * @brief Выполняет задачи на временном пуле потоков.
+ *
+ * Для однократных прогонов; при повторных вызовах пул лучше создать
+ * один раз через pool_create.
+ * @param threads Количество рабочих потоков (не меньше 1).
+ * @param task_count Количество задач.
+ * @param fn Функция, выполняющая одну задачу.
+ * @param context Контекст, передаваемый в fn.
+ * @param stats Массив из threads элементов для статистики потоков или NULL.
+ * @return int 0 при успехе, -1 при ошибке выделения памяти.
+ */
+int run_work_stealing(int threads, int64_t task_count, TaskFn_t fn,
+                      void *context, WorkerStats_t *stats) {
+  WorkerPool_t *pool = pool_create(threads);
+  int status = -1;
+  if (pool != NULL) {
+    status = pool_run(pool, task_count, fn, context, stats);
+    pool_destroy(pool);
+  }
+  return status;
+}
@@ -0,0 +1,37 @@
+#ifndef CMD_SCHEDULER_H
+#define CMD_SCHEDULER_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+  _Atomic int64_t top;
+  _Atomic int64_t bottom;
+  _Atomic int64_t *buffer;
+  int64_t mask;
+} WorkDeque_t;
+
+typedef struct {
+  long tasks_run;
+  long steals;
+} WorkerStats_t;
+
+typedef void (*TaskFn_t)(void *context, int worker, int64_t task);
+
+typedef struct WorkerPool WorkerPool_t;
+
+bool deque_init(WorkDeque_t *deque, int64_t capacity);
+void deque_free(WorkDeque_t *deque);
+bool deque_push(WorkDeque_t *deque, int64_t task);
+bool deque_pop(WorkDeque_t *deque, int64_t *task);
+bool deque_steal(WorkDeque_t *deque, int64_t *task);
+
+WorkerPool_t *pool_create(int threads);
+int pool_run(WorkerPool_t *pool, int64_t task_count, TaskFn_t fn,
+             void *context, WorkerStats_t *stats);
+void pool_destroy(WorkerPool_t *pool);
+int run_work_stealing(int threads, int64_t task_count, TaskFn_t fn,
+                      void *context, WorkerStats_t *stats);
+
+#endif
@@ -0,0 +1,224 @@
+#include "sim.h"
+
+#define DEFAULT_GAMES 1000
+#define DEFAULT_MAX_TICKS 1000000L
+
+typedef struct {
+  uint64_t base_seed;
+  long max_ticks;
+  int *scores;
+  long *pieces;
+  long *ticks;
+  MoveGen_t *gens;
+  UserAction_t (*paths)[MOVEGEN_MAX_STATES];
+} SimContext_t;
+
+/**
+ * @brief Политика бота: выбирает положение фигуры и строит путь к нему.
+ *
+ * Из всех положений, достижимых генератором ходов, выбирается самое
+ * низкое (наибольшая сумма номеров строк клеток фигуры), при равенстве —
+ * случайное. Такой бот очищает линии, поэтому распределение очков
+ * осмысленно. Хвост пути из шагов гравитации перед фиксацией отбрасывается:
+ * жесткое падение приводит фигуру в ту же точку.
+ * @param gen Рабочая область генератора ходов.
+ * @param rng Генератор политики.
+ * @param game Игра в состоянии Moving.
+ * @param path Буфер для пути длиной MOVEGEN_MAX_STATES.
+ * @return int Длина пути; 0, если положений нет.
+ */
+static int plan_placement(MoveGen_t *gen, Rng_t *rng, const GameData_t *game,
+                          UserAction_t *path) {
+  int count = generate_placements(gen, game, &game->current_piece);
+  int best = -1, best_depth = -1, ties = 0;
+  for (int i = 0; i < count; i++) {
+    CurrentPiece_t piece = placement_piece(gen, i);
+    const PieceRotation_t *rotation = piece_rotation(&piece);
+    int depth = 0;
+    for (int row = 0; row < 4; row++) {
+      depth += __builtin_popcount(rotation->rows[row]) * (piece.y + row);
+    }
+    if (depth > best_depth) {
+      best = i;
+      best_depth = depth;
+      ties = 1;
+    } else if (depth == best_depth && rng_below(rng, (uint32_t)++ties) == 0) {
+      best = i;
+    }
+  }
+  if (best < 0) return 0;
+
+  int length = placement_path(gen, best, path, MOVEGEN_MAX_STATES);
+  while (length > 1 && path[length - 2] == ActionNone) {
+    path[length - 2] = ActionMoveDown;
+    length--;
+  }
+  return length;
+}
+
+/**
+ * @brief Играет одну игру целиком; задача для планировщика.
+ *
+ * Для каждой фигуры бот один раз выбирает положение (plan_placement) и
+ * выполняет путь: ходы применяются сразу, а ActionNone в пути означает
+ * ожидание шага гравитации. После ходов часы переводятся к следующему
+ * событию движка (advance_game), поэтому время симуляции определяется
+ * числом событий, а не числом тиков.
+ * @param context Указатель на SimContext_t.
+ * @param worker Номер потока; по нему берутся рабочие области бота.
+ * @param index Номер игры; игра засевается значением base_seed + index.
+ */
+static void play_one_game(void *context, int worker, int64_t index) {
+  SimContext_t *sim = context;
+  uint64_t seed = sim->base_seed + (uint64_t)index;
+
+  GameData_t game;
+  initialize_game_core(&game, 0, seed);
+  set_settle_transitions(&game, true);
+  Rng_t policy;
+  rng_seed(&policy, ~seed);
+  MoveGen_t *gen = &sim->gens[worker];
+  UserAction_t *path = sim->paths[worker];
+  int length = 0, step = 0;
+  long planned = -1;
+
+  apply_user_action(&game, ActionStart);
+  while (game.timer.tick < sim->max_ticks && game.state != GameOver) {
+    if (game.state == Moving) {
+      if (game.piece_count != planned) {
+        length = plan_placement(gen, &policy, &game, path);
+        step = 0;
+        planned = game.piece_count;
+      }
+      while (step < length && path[step] != ActionNone) {
+        apply_user_action(&game, path[step++]);
+      }
+      if (step < length) step++;
+    }
+    advance_game(&game, next_event_tick(&game) - game.timer.tick + 1);
+  }
+
+  sim->scores[index] = game.info.score;
+  sim->pieces[index] = game.piece_count;
+  sim->ticks[index] = game.timer.tick;
+}
+
+static int compare_ints(const void *a, const void *b) {
+  int left = *(const int *)a, right = *(const int *)b;
+  return (left > right) - (left < right);
+}
+
+static int percentile(const int *sorted, long count, int p) {
+  return sorted[(count - 1) * p / 100];
+}
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Выводит пропускную способность и распределение очков.
+ *
+ * @param sim Результаты игр; массив очков при этом сортируется.
+ * @param games Количество игр.
+ * @param threads Количество потоков.
+ * @param elapsed Время прогона в секундах.
+ * @param stats Статистика потоков.
+ */
+static void print_report(SimContext_t *sim, long games, int threads,
+                         double elapsed, const WorkerStats_t *stats) {
+  long total_pieces = 0, total_ticks = 0, steals = 0;
+  double score_sum = 0;
+  for (long i = 0; i < games; i++) {
+    total_pieces += sim->pieces[i];
+    total_ticks += sim->ticks[i];
+    score_sum += sim->scores[i];
+  }
+  for (int i = 0; i < threads; i++) steals += stats[i].steals;
+  qsort(sim->scores, (size_t)games, sizeof(int), compare_ints);
+
+  printf("games:       %ld\n", games);
+  printf("threads:     %d\n", threads);
+  printf("base seed:   %llu\n", (unsigned long long)sim->base_seed);
+  printf("elapsed:     %.3f s\n", elapsed);
+  printf("games/s:     %.1f\n", (double)games / elapsed);
+  printf("pieces/s:    %.1f\n", (double)total_pieces / elapsed);
+  printf("ticks/s:     %.1f\n", (double)total_ticks / elapsed);
+  printf("steals:      %ld\n", steals);
+  printf("score: mean %.1f min %d p25 %d p50 %d p75 %d p90 %d p99 %d max %d\n",
+         score_sum / (double)games, sim->scores[0],
+         percentile(sim->scores, games, 25),
+         percentile(sim->scores, games, 50),
+         percentile(sim->scores, games, 75),
+         percentile(sim->scores, games, 90),
+         percentile(sim->scores, games, 99), sim->scores[games - 1]);
+}
+
+static void print_usage(const char *name) {
+  fprintf(stderr,
+          "Usage: %s [-g games] [-t threads] [-s seed] [-m max_ticks]\n",
+          name);
+}
+
+int main(int argc, char **argv) {
+  long games = DEFAULT_GAMES;
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  int threads = cpus > 0 ? (int)cpus : 1;
+  SimContext_t sim = {1, DEFAULT_MAX_TICKS, NULL, NULL, NULL, NULL, NULL};
+
+  int option;
+  while ((option = getopt(argc, argv, "g:t:s:m:h")) != -1) {
+    switch (option) {
+      case 'g':
+        games = strtol(optarg, NULL, 10);
+        break;
+      case 't':
+        threads = (int)strtol(optarg, NULL, 10);
+        break;
+      case 's':
+        sim.base_seed = strtoull(optarg, NULL, 10);
+        break;
+      case 'm':
+        sim.max_ticks = strtol(optarg, NULL, 10);
+        break;
+      default:
+        print_usage(argv[0]);
+        return option == 'h' ? 0 : 1;
+    }
+  }
+  if (games < 1 || threads < 1 || sim.max_ticks < 1) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  sim.scores = calloc((size_t)games, sizeof(int));
+  sim.pieces = calloc((size_t)games, sizeof(long));
+  sim.ticks = calloc((size_t)games, sizeof(long));
+  sim.gens = calloc((size_t)threads, sizeof(MoveGen_t));
+  sim.paths = calloc((size_t)threads, sizeof(*sim.paths));
+  WorkerStats_t *stats = calloc((size_t)threads, sizeof(WorkerStats_t));
+  int status = 1;
+  if (!sim.scores || !sim.pieces || !sim.ticks || !sim.gens || !sim.paths ||
+      !stats) {
+    fprintf(stderr, "Out of memory\n");
+  } else {
+    init_piece_tables();
+    double started = now_seconds();
+    if (run_work_stealing(threads, games, play_one_game, &sim, stats) != 0) {
+      fprintf(stderr, "Failed to start worker threads\n");
+    } else {
+      print_report(&sim, games, threads, now_seconds() - started, stats);
+      status = 0;
+    }
+  }
+
+  free(sim.scores);
+  free(sim.pieces);
+  free(sim.ticks);
+  free(sim.gens);
+  free(sim.paths);
+  free(stats);
+  return status;
+}
\ No newline at end of file
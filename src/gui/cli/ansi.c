@@ -0,0 +1,342 @@
+#include "gui/cli/ansi.h"
+
+#include <stdio.h>
+
+// Первая клетка внутри рамки каждого окна; строки и столбцы терминала
+// в последовательностях ANSI нумеруются с единицы
+#define BOARD_TOP (BOARD_WINDOW_Y + 2)
+#define BOARD_LEFT (BOARD_WINDOW_X + 2)
+#define INFO_TOP (INFO_WINDOW_Y + 2)
+#define INFO_LEFT (INFO_WINDOW_X + 2)
+
+// Цвет фона ANSI для индекса цвета клетки (0 — пустая клетка)
+static const int CELL_COLORS[8] = {0, 6, 3, 5, 7, 4, 2, 1};
+
+/**
+ * @brief Дописывает байты в буфер кадра.
+ *
+ * При нехватке места байты отбрасываются и выставляется флаг overflow:
+ * незавершенная строка откатывается в ansi_render_frame.
+ * @param renderer Указатель на состояние отрисовки.
+ * @param bytes Дописываемые байты.
+ * @param length Их количество.
+ */
+static void append(AnsiRenderer_t *renderer, const char *bytes,
+                   size_t length) {
+  if (renderer->length + length > ANSI_BUFFER_SIZE) {
+    renderer->overflow = true;
+    return;
+  }
+  memcpy(renderer->buffer + renderer->length, bytes, length);
+  renderer->length += length;
+}
+
+static void append_str(AnsiRenderer_t *renderer, const char *text) {
+  append(renderer, text, strlen(text));
+}
+
+/**
+ * @brief Записывает в seq управляющую последовательность с числом.
+ *
+ * Единица опускается: терминал подставляет ее по умолчанию.
+ * @return int Длина последовательности.
+ */
+static int csi_count(char *seq, int count, char command) {
+  if (count == 1) return snprintf(seq, 16, "\033[%c", command);
+  return snprintf(seq, 16, "\033[%d%c", count, command);
+}
+
+/**
+ * @brief Переводит курсор в заданную позицию самой короткой командой.
+ *
+ * Сравниваются абсолютное перемещение и относительные сдвиги по строке
+ * или столбцу; если позиция совпадает с текущей, ничего не выводится.
+ * @param renderer Указатель на состояние отрисовки.
+ * @param row Строка терминала.
+ * @param col Столбец терминала.
+ */
+static void move_cursor(AnsiRenderer_t *renderer, int row, int col) {
+  if (renderer->row == row && renderer->col == col) return;
+
+  char best[16], seq[16];
+  int best_length = col == 1 ? snprintf(best, 16, "\033[%dH", row)
+                             : snprintf(best, 16, "\033[%d;%dH", row, col);
+  int length = 0;
+  if (renderer->row == row && renderer->col > 0) {
+    length = col > renderer->col ? csi_count(seq, col - renderer->col, 'C')
+                                 : csi_count(seq, renderer->col - col, 'D');
+  } else if (renderer->col == col && renderer->row > 0) {
+    length = row > renderer->row ? csi_count(seq, row - renderer->row, 'B')
+                                 : csi_count(seq, renderer->row - row, 'A');
+  }
+  if (length > 0 && length < best_length) {
+    memcpy(best, seq, (size_t)length);
+    best_length = length;
+  }
+  append(renderer, best, (size_t)best_length);
+  renderer->row = row;
+  renderer->col = col;
+}
+
+/**
+ * @brief Меняет цвет фона, только если он отличается от текущего.
+ *
+ * Цвет символов весь кадр остается белым, поэтому подряд идущие клетки
+ * одного цвета выводятся без единой управляющей последовательности.
+ * @param renderer Указатель на состояние отрисовки.
+ * @param color Индекс цвета клетки (0 — черный фон).
+ */
+static void set_color(AnsiRenderer_t *renderer, int color) {
+  if (renderer->color == color) return;
+  char seq[16];
+  int length = snprintf(seq, sizeof(seq), "\033[4%dm", CELL_COLORS[color]);
+  append(renderer, seq, (size_t)length);
+  renderer->color = color;
+}
+
+static void put_text(AnsiRenderer_t *renderer, int row, int col,
+                     const char *text) {
+  move_cursor(renderer, row, col);
+  set_color(renderer, 0);
+  append_str(renderer, text);
+  renderer->col += (int)strlen(text);
+}
+
+static void put_cell(AnsiRenderer_t *renderer, int row, int col, int color) {
+  move_cursor(renderer, row, col);
+  // Тень фигуры — скобки белым цветом на черном фоне
+  bool ghost = color == FRAME_GHOST;
+  set_color(renderer, ghost ? 0 : color);
+  append(renderer, ghost ? "[]" : "  ", 2);
+  renderer->col += 2;
+}
+
+/**
+ * @brief Рисует рамку окна символами псевдографики DEC.
+ */
+static void draw_box(AnsiRenderer_t *renderer, int top, int left,
+                     int width) {
+  char line[64];
+  line[0] = 'l';
+  memset(line + 1, 'q', (size_t)width - 2);
+  line[width - 1] = 'k';
+  line[width] = '\0';
+  put_text(renderer, top, left, line);
+  line[0] = 'm';
+  line[width - 1] = 'j';
+  put_text(renderer, top + WINDOW_HEIGHT - 1, left, line);
+  for (int y = 1; y < WINDOW_HEIGHT - 1; y++) {
+    put_text(renderer, top + y, left, "x");
+    put_text(renderer, top + y, left + width - 1, "x");
+  }
+}
+
+/**
+ * @brief Подготавливает отрисовку и помещает в буфер статичную часть
+ * экрана.
+ *
+ * В буфер попадают очистка экрана, скрытие курсора, рамки окон и подписи;
+ * они выводятся вместе с первым кадром и не учитываются в бюджете.
+ * @param renderer Указатель на состояние отрисовки.
+ * @param budget Предел байт на кадр (0 — без ограничения).
+ */
+void ansi_renderer_init(AnsiRenderer_t *renderer, size_t budget) {
+  renderer->length = 0;
+  renderer->overflow = false;
+  renderer->budget = budget;
+  renderer->resume_row = 0;
+  renderer->frames = 0;
+  renderer->deferred_frames = 0;
+  renderer->total_bytes = 0;
+  renderer->max_frame_bytes = 0;
+  invalidate_frame(&renderer->shown);
+
+  append_str(renderer, "\033[?25l\033[0;37;40m\033[2J\033(0");
+  renderer->row = 0;
+  renderer->col = 0;
+  renderer->color = 0;
+  draw_box(renderer, BOARD_TOP - 1, BOARD_LEFT - 1, BOARD_WINDOW_WIDTH);
+  draw_box(renderer, INFO_TOP - 1, INFO_LEFT - 1, INFO_WINDOW_WIDTH);
+  append_str(renderer, "\033(B");
+  put_text(renderer, INFO_TOP + 6, INFO_LEFT + 1, "Next:");
+}
+
+/**
+ * @brief Выводит измененные клетки одной строки поля.
+ *
+ * Короткий промежуток из неизмененных клеток текущего цвета выгоднее
+ * перерисовать, чем перепрыгнуть командой перемещения курсора.
+ * @param renderer Указатель на состояние отрисовки.
+ * @param frame Новый кадр.
+ * @param y Строка поля.
+ * @param full Перерисовать строку целиком.
+ */
+static void render_row(AnsiRenderer_t *renderer, const Frame_t *frame, int y,
+                       bool full) {
+  const uint8_t *cells = frame->cells[y];
+  int row = BOARD_TOP + y;
+  for (int x = 0; x < BOARD_WIDTH; x++) {
+    if (!full && cells[x] == renderer->shown.cells[y][x]) continue;
+
+    int col = BOARD_LEFT + x * 2;
+    if (renderer->row == row && renderer->col < col &&
+        renderer->col >= BOARD_LEFT) {
+      int from = (renderer->col - BOARD_LEFT) / 2;
+      bool same_color = col - renderer->col <= 4;
+      for (int k = from; k < x && same_color; k++) {
+        same_color = cells[k] == renderer->color;
+      }
+      for (int k = from; k < x && same_color; k++) {
+        append(renderer, "  ", 2);
+        renderer->col += 2;
+      }
+    }
+    put_cell(renderer, row, col, cells[x]);
+  }
+}
+
+static void render_number(AnsiRenderer_t *renderer, int line,
+                          const char *label, int value) {
+  char text[32];
+  snprintf(text, sizeof(text), "%s%-9d", label, value);
+  put_text(renderer, INFO_TOP + line - 1, INFO_LEFT + 1, text);
+}
+
+/**
+ * @brief Выводит изменившиеся поля панели информации.
+ */
+static void render_info(AnsiRenderer_t *renderer, const Frame_t *frame) {
+  Frame_t *shown = &renderer->shown;
+  if (frame->score != shown->score)
+    render_number(renderer, 2, "Score: ", frame->score);
+  if (frame->high_score != shown->high_score)
+    render_number(renderer, 3, "High:  ", frame->high_score);
+  if (frame->level != shown->level)
+    render_number(renderer, 4, "Level: ", frame->level);
+  if (frame->next_piece != shown->next_piece) {
+    for (int i = 0; i < 4; i++) {
+      for (int j = 0; j < 4; j++) {
+        int color =
+            FIGURES[frame->next_piece][i][j] ? frame->next_piece + 1 : 0;
+        put_cell(renderer, INFO_TOP + PREVIEW_ROW - 1 + i,
+                 INFO_LEFT + PREVIEW_COL - 1 + j * 2, color);
+      }
+    }
+  }
+  for (int k = 0; k < FRAME_QUEUE; k++) {
+    int piece = frame->queue[k];
+    if (piece == shown->queue[k]) continue;
+    for (int i = 1; i < 3; i++) {
+      for (int j = 0; j < 4; j++) {
+        put_cell(renderer, INFO_TOP + QUEUE_ROW + k * QUEUE_STEP + i - 2,
+                 INFO_LEFT + PREVIEW_COL - 1 + j * 2,
+                 piece >= 0 && FIGURES[piece][i][j] ? piece + 1 : 0);
+      }
+    }
+    shown->queue[k] = piece;
+  }
+  shown->score = frame->score;
+  shown->high_score = frame->high_score;
+  shown->level = frame->level;
+  shown->next_piece = frame->next_piece;
+}
+
+/**
+ * @brief Проверяет, уложилась ли часть кадра в бюджет, и откатывает ее,
+ * если нет.
+ *
+ * Самая первая часть кадра выводится всегда, иначе при маленьком бюджете
+ * экран никогда бы не обновился.
+ * @return true Если часть оставлена в буфере.
+ */
+static bool fits_budget(AnsiRenderer_t *renderer, size_t frame_start,
+                        size_t chunk_start, int row, int col, int color) {
+  size_t used = renderer->length - frame_start;
+  bool over = renderer->budget && used > renderer->budget &&
+              chunk_start > frame_start;
+  if (!renderer->overflow && !over) return true;
+  renderer->length = chunk_start;
+  renderer->overflow = false;
+  renderer->row = row;
+  renderer->col = col;
+  renderer->color = color;
+  return false;
+}
+
+/**
+ * @brief Дописывает в буфер разницу между кадром на экране и новым.
+ *
+ * Выводятся только изменившиеся клетки и поля панели: курсор
+ * перемещается самой короткой командой, цвет меняется только на границах
+ * участков разного цвета. Если задан бюджет, строки поля, не уместившиеся
+ * в него, остаются в теневой копии старыми и дорисовываются в следующих
+ * кадрах.
+ * @param renderer Указатель на состояние отрисовки.
+ * @param frame Новый кадр.
+ * @return size_t Количество байт в буфере, готовых к выводу.
+ */
+size_t ansi_render_frame(AnsiRenderer_t *renderer, const Frame_t *frame) {
+  Frame_t *shown = &renderer->shown;
+  size_t frame_start = renderer->length;
+  bool complete = true;
+
+  size_t chunk = renderer->length;
+  int row = renderer->row, col = renderer->col, color = renderer->color;
+  Frame_t saved = *shown;
+  render_info(renderer, frame);
+  if (!fits_budget(renderer, frame_start, chunk, row, col, color)) {
+    *shown = saved;
+    complete = false;
+  }
+
+  uint32_t dirty = frame_dirty_rows(shown, frame);
+  bool overlay_removed =
+      shown->overlay != OverlayNone && frame->overlay != shown->overlay;
+  if (overlay_removed) dirty |= 1u << OVERLAY_ROW;
+  bool overlay_row_drawn = false;
+  // Обход начинается со строки, на которой остановился прошлый кадр, —
+  // иначе часто меняющиеся верхние строки не пускали бы очередь к нижним
+  for (int i = 0; i < BOARD_HEIGHT && complete; i++) {
+    int y = (renderer->resume_row + i) % BOARD_HEIGHT;
+    if (!(dirty >> y & 1)) continue;
+    chunk = renderer->length;
+    row = renderer->row, col = renderer->col, color = renderer->color;
+    render_row(renderer, frame, y, overlay_removed && y == OVERLAY_ROW);
+    if (fits_budget(renderer, frame_start, chunk, row, col, color)) {
+      memcpy(shown->cells[y], frame->cells[y], BOARD_WIDTH);
+      overlay_row_drawn |= y == OVERLAY_ROW;
+    } else {
+      renderer->resume_row = y;
+      complete = false;
+    }
+  }
+
+  // Надпись снимается вместе с перерисовкой строки под ней
+  const char *message = overlay_message(frame->overlay);
+  if (complete && (frame->overlay != shown->overlay || overlay_row_drawn)) {
+    if (message) {
+      int length = (int)strlen(message);
+      put_text(renderer, BOARD_TOP + OVERLAY_ROW,
+               BOARD_LEFT - 1 + (BOARD_WINDOW_WIDTH - length) / 2, message);
+    }
+    shown->overlay = frame->overlay;
+  }
+
+  size_t bytes = renderer->length - frame_start;
+  if (bytes > 0) {
+    renderer->frames++;
+    renderer->total_bytes += bytes;
+    if (bytes > renderer->max_frame_bytes) renderer->max_frame_bytes = bytes;
+  }
+  if (!complete) renderer->deferred_frames++;
+  return renderer->length;
+}
+
+/**
+ * @brief Отмечает содержимое буфера выведенным.
+ *
+ * @param renderer Указатель на состояние отрисовки.
+ */
+void ansi_renderer_consume(AnsiRenderer_t *renderer) {
+  renderer->length = 0;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef GUI_CLI_ANSI_H
+#define GUI_CLI_ANSI_H
+
+#include <stddef.h>
+
+#include "gui/cli/frame.h"
+
+#define ANSI_BUFFER_SIZE 16384
+
+typedef struct {
+  char buffer[ANSI_BUFFER_SIZE];
+  size_t length;
+  bool overflow;
+  int row;
+  int col;
+  int color;
+  size_t budget;
+  int resume_row;
+  Frame_t shown;
+  long frames;
+  long deferred_frames;
+  size_t total_bytes;
+  size_t max_frame_bytes;
+} AnsiRenderer_t;
+
+void ansi_renderer_init(AnsiRenderer_t *renderer, size_t budget);
+size_t ansi_render_frame(AnsiRenderer_t *renderer, const Frame_t *frame);
+void ansi_renderer_consume(AnsiRenderer_t *renderer);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,125 @@
+#define _DEFAULT_SOURCE
+#include "ansi_view.h"
+
+#include <errno.h>
+
+// Выводит буфер кадра одним вызовом write; повтор нужен только при
+// частичной записи или прерывании сигналом
+static void flush_output(Renderer_t *renderer) {
+  AnsiView_t *view = renderer->state;
+  AnsiRenderer_t *ansi = &view->renderer;
+  size_t written = 0;
+  while (written < ansi->length) {
+    ssize_t result =
+        write(view->output_fd, ansi->buffer + written, ansi->length - written);
+    if (result < 0 && errno == EINTR) continue;
+    if (result <= 0) break;
+    written += (size_t)result;
+  }
+  renderer->bytes += written;
+  ansi_renderer_consume(ansi);
+}
+
+static void write_sequence(const AnsiView_t *view, const char *sequence) {
+  ssize_t result = write(view->output_fd, sequence, strlen(sequence));
+  (void)result;
+}
+
+static bool ansi_init_terminal(Renderer_t *renderer) {
+  AnsiView_t *view = renderer->state;
+  if (!view) return false;
+  if (view->terminal) {
+    if (tcgetattr(STDIN_FILENO, &view->saved_termios) != 0) return false;
+
+    // Неканонический режим без эха: read возвращает то, что уже пришло,
+    // и не ждет новых байт — ожидание ввода остается за ppoll
+    struct termios raw = view->saved_termios;
+    raw.c_iflag &= ~(ICRNL | IXON);
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0) return false;
+    write_sequence(view, "\033[?1049h");
+  }
+
+  view->input_length = 0;
+  view->input_position = 0;
+  ansi_renderer_init(&view->renderer, view->renderer.budget);
+  flush_output(renderer);
+  return true;
+}
+
+static void ansi_cleanup_terminal(Renderer_t *renderer) {
+  AnsiView_t *view = renderer->state;
+  if (view->terminal) {
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &view->saved_termios);
+    write_sequence(view, "\033[0m\033[?25h\033[?1049l");
+  }
+  free(view);
+  renderer->state = NULL;
+}
+
+static void ansi_draw_game(Renderer_t *renderer, const GameData_t *game) {
+  AnsiView_t *view = renderer->state;
+  Frame_t frame;
+  compose_frame(game, &renderer->ghost, &frame);
+  ansi_render_frame(&view->renderer, &frame);
+  renderer->frames++;
+  if (view->renderer.length > 0) flush_output(renderer);
+}
+
+// Возвращает следующий байт ввода или -1, если ввод исчерпан
+static int next_byte(AnsiView_t *view) {
+  if (view->input_position == view->input_length) {
+    ssize_t result = read(STDIN_FILENO, view->input, sizeof(view->input));
+    view->input_position = 0;
+    view->input_length = result > 0 ? (int)result : 0;
+    if (view->input_length == 0) return -1;
+  }
+  return view->input[view->input_position++];
+}
+
+static int ansi_read_key(Renderer_t *renderer) {
+  AnsiView_t *view = renderer->state;
+  if (!view->terminal) return ERR;
+  int byte = next_byte(view);
+  if (byte < 0) return ERR;
+  if (byte == '\r') return '\n';
+  if (byte != '\033') return byte;
+
+  // Стрелки приходят как ESC [ X или ESC O X (режим клавиш приложения)
+  int prefix = next_byte(view);
+  if (prefix != '[' && prefix != 'O') {
+    if (prefix >= 0) view->input_position--;
+    return byte;
+  }
+  switch (next_byte(view)) {
+    case 'A':
+      return KEY_UP;
+    case 'B':
+      return KEY_DOWN;
+    case 'C':
+      return KEY_RIGHT;
+    case 'D':
+      return KEY_LEFT;
+    default:
+      return byte;
+  }
+}
+
+// Вывод в STDOUT_FILENO считается терминалом: он переводится в
+// неканонический режим, и с него же читаются нажатия. Вывод в другой
+// дескриптор (файл, /dev/null) только пишет кадры.
+void ansi_view_renderer(Renderer_t *renderer, int output_fd, size_t budget) {
+  AnsiView_t *view = calloc(1, sizeof(AnsiView_t));
+  if (view) {
+    view->output_fd = output_fd;
+    view->terminal = output_fd == STDOUT_FILENO;
+    view->renderer.budget = budget;
+  }
+  *renderer = (Renderer_t){"ansi",        ansi_init_terminal,
+                           ansi_draw_game, ansi_read_key,
+                           ansi_cleanup_terminal, view,
+                           0,             0,
+                           {0}};
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef GUI_CLI_ANSI_VIEW_H
+#define GUI_CLI_ANSI_VIEW_H
+
+#include <termios.h>
+#include <unistd.h>
+
+#include "brickgame/tetris/tetris.h"
+#include "gui/cli/ansi.h"
+#include "gui/cli/renderer.h"
+
+#define ANSI_INPUT_BUFFER_SIZE 64
+
+typedef struct {
+  AnsiRenderer_t renderer;
+  int output_fd;
+  bool terminal;
+  struct termios saved_termios;
+  unsigned char input[ANSI_INPUT_BUFFER_SIZE];
+  int input_length;
+  int input_position;
+} AnsiView_t;
+
+void ansi_view_renderer(Renderer_t *renderer, int output_fd, size_t budget);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "gui/cli/frame.h"
+
+/**
+ * @brief Сбрасывает кэш тени фигуры и счетчик пересчетов.
+ *
+ * @param ghost Указатель на кэш.
+ */
+void reset_ghost(GhostCache_t *ghost) {
+  memset(ghost, 0, sizeof(*ghost));
+}
+
+/**
+ * @brief Возвращает строку, на которую приземлится текущая фигура.
+ *
+ * Результат кэшируется и пересчитывается, только если фигура сдвинулась
+ * или повернулась, либо изменилось поле (`board_version`). Падение по
+ * таймеру пересчета не требует: пока фигура выше поверхности всех своих
+ * столбцов, точка приземления от ее высоты не зависит. Только если она
+ * прошла под навес (профиль высот неоднозначен), кэш учитывает и y.
+ * @param ghost Указатель на кэш; ghost->recomputes считает пересчеты.
+ * @param game Указатель на главную структуру данных игры.
+ * @return int Координата y фигуры в точке приземления.
+ */
+int ghost_landing_y(GhostCache_t *ghost, const GameData_t *game) {
+  const CurrentPiece_t *piece = &game->current_piece;
+  if (ghost->valid && ghost->piece == piece->piece &&
+      ghost->rotation == piece->rotation && ghost->x == piece->x &&
+      ghost->board_version == game->board_version &&
+      (ghost->exact || ghost->y == piece->y)) {
+    return ghost->landing_y;
+  }
+
+  int drop = profile_drop_distance(game);
+  ghost->exact = drop >= 0;
+  if (!ghost->exact) drop = drop_distance(game);
+  ghost->valid = true;
+  ghost->piece = piece->piece;
+  ghost->rotation = piece->rotation;
+  ghost->x = piece->x;
+  ghost->y = piece->y;
+  ghost->board_version = game->board_version;
+  ghost->landing_y = piece->y + drop;
+  ghost->recomputes++;
+  return ghost->landing_y;
+}
+
+/**
+ * @brief Впечатывает клетки фигуры в кадр на заданной высоте.
+ *
+ * @param frame Кадр.
+ * @param piece Фигура.
+ * @param top Координата y фигуры.
+ * @param value Значение клеток (цвет или FRAME_GHOST).
+ */
+static void put_piece(Frame_t *frame, const CurrentPiece_t *piece, int top,
+                      uint8_t value) {
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      int y = top + i, x = piece->x + j;
+      if (piece_cell(piece, i, j) && y >= 0 && y < BOARD_HEIGHT && x >= 0 &&
+          x < BOARD_WIDTH) {
+        frame->cells[y][x] = value;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Собирает кадр — все, что видно на экране, — из состояния игры.
+ *
+ * Падающая фигура впечатывается в копию поля, поэтому сравнение двух
+ * кадров сразу дает и старый, и новый след фигуры, и очищенные линии.
+ * Под фигурой рисуется ее тень (FRAME_GHOST) в точке приземления. В
+ * панель попадают следующая фигура и до FRAME_QUEUE фигур за ней из
+ * очереди предпросмотра (-1 — фигура неизвестна).
+ * @param game Указатель на главную структуру данных игры.
+ * @param ghost Кэш тени фигуры; NULL — кадр без тени.
+ * @param frame Структура, в которую записывается кадр.
+ */
+void compose_frame(const GameData_t *game, GhostCache_t *ghost,
+                   Frame_t *frame) {
+  memcpy(frame->cells, game->board, sizeof(frame->cells));
+
+  if (game->state == Moving || game->state == Shifting ||
+      game->state == Attaching) {
+    const CurrentPiece_t *piece = &game->current_piece;
+    if (ghost) {
+      put_piece(frame, piece, ghost_landing_y(ghost, game), FRAME_GHOST);
+    }
+    put_piece(frame, piece, piece->y, (uint8_t)piece->color_index);
+  }
+
+  frame->score = game->info.score;
+  frame->high_score = game->info.high_score;
+  frame->level = game->info.level;
+  frame->next_piece = game->next_piece_index;
+  for (int i = 0; i < FRAME_QUEUE; i++) {
+    frame->queue[i] = preview_piece(game, i + 1);
+  }
+  if (game->info.pause)
+    frame->overlay = OverlayPause;
+  else if (game->state == GameOver)
+    frame->overlay = OverlayGameOver;
+  else
+    frame->overlay = OverlayNone;
+}
+
+/**
+ * @brief Делает кадр заведомо отличным от любого собранного кадра.
+ *
+ * Используется для теневой копии экрана перед первой отрисовкой и после
+ * очистки терминала: следующее сравнение перерисует все.
+ * @param frame Указатель на кадр.
+ */
+void invalidate_frame(Frame_t *frame) {
+  memset(frame->cells, 0xFF, sizeof(frame->cells));
+  frame->score = -1;
+  frame->high_score = -1;
+  frame->level = -1;
+  frame->next_piece = -1;
+  // -1 в очереди означает пустое место, поэтому здесь другое значение
+  for (int i = 0; i < FRAME_QUEUE; i++) frame->queue[i] = -2;
+  frame->overlay = (FrameOverlay_t)-1;
+}
+
+/**
+ * @brief Находит строки поля, которые отличаются в двух кадрах.
+ *
+ * @param shown Кадр, который сейчас на экране.
+ * @param frame Новый кадр.
+ * @return uint32_t Битовая маска: бит y установлен, если строка y
+ * изменилась.
+ */
+uint32_t frame_dirty_rows(const Frame_t *shown, const Frame_t *frame) {
+  uint32_t dirty = 0;
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    if (memcmp(shown->cells[y], frame->cells[y], BOARD_WIDTH) != 0) {
+      dirty |= 1u << y;
+    }
+  }
+  return dirty;
+}
+
+/**
+ * @brief Возвращает текст надписи поверх поля.
+ *
+ * @param overlay Вид надписи.
+ * @return const char* Текст или NULL, если надписи нет.
+ */
+const char *overlay_message(FrameOverlay_t overlay) {
+  switch (overlay) {
+    case OverlayPause:
+      return "PAUSE";
+    case OverlayGameOver:
+      return "GAME OVER";
+    default:
+      return NULL;
+  }
+}
\ No newline at end of file
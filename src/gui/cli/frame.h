@@ -0,0 +1,59 @@
+#ifndef GUI_CLI_FRAME_H
+#define GUI_CLI_FRAME_H
+
+#include "brickgame/tetris/tetris_core.h"
+
+// Раскладка экрана в клетках терминала (с нуля): окно поля и окно панели
+#define WINDOW_HEIGHT (BOARD_HEIGHT + 2)
+#define BOARD_WINDOW_Y 1
+#define BOARD_WINDOW_X 1
+#define BOARD_WINDOW_WIDTH (BOARD_WIDTH * 2 + 2)
+#define INFO_WINDOW_Y 1
+#define INFO_WINDOW_X (BOARD_WIDTH * 2 + 4)
+#define INFO_WINDOW_WIDTH 20
+#define SCREEN_HEIGHT (INFO_WINDOW_Y + WINDOW_HEIGHT)
+#define SCREEN_WIDTH (INFO_WINDOW_X + INFO_WINDOW_WIDTH)
+#define OVERLAY_ROW (WINDOW_HEIGHT / 2 - 2)
+#define PREVIEW_ROW 9
+#define PREVIEW_COL 5
+// Фигуры после следующей: по две средние строки матрицы 4x4 на фигуру
+#define FRAME_QUEUE 3
+#define QUEUE_ROW (PREVIEW_ROW + 4)
+#define QUEUE_STEP 3
+
+// Значение клетки кадра для тени фигуры (цвета клеток — от 0 до 7)
+#define FRAME_GHOST 8
+
+typedef enum { OverlayNone, OverlayPause, OverlayGameOver } FrameOverlay_t;
+
+typedef struct {
+  bool valid;
+  bool exact;
+  int piece;
+  int rotation;
+  int x;
+  int y;
+  uint32_t board_version;
+  int landing_y;
+  long recomputes;
+} GhostCache_t;
+
+typedef struct {
+  uint8_t cells[BOARD_HEIGHT][BOARD_WIDTH];
+  int score;
+  int high_score;
+  int level;
+  int next_piece;
+  int queue[FRAME_QUEUE];
+  FrameOverlay_t overlay;
+} Frame_t;
+
+void reset_ghost(GhostCache_t *ghost);
+int ghost_landing_y(GhostCache_t *ghost, const GameData_t *game);
+void compose_frame(const GameData_t *game, GhostCache_t *ghost,
+                   Frame_t *frame);
+void invalidate_frame(Frame_t *frame);
+uint32_t frame_dirty_rows(const Frame_t *shown, const Frame_t *frame);
+const char *overlay_message(FrameOverlay_t overlay);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include "gui/cli/renderer.h"
+
+#include <stdio.h>
+
+// Код «нет нажатия», совпадающий с ERR из ncurses
+#define NO_KEY (-1)
+
+static bool null_init(Renderer_t *renderer) {
+  (void)renderer;
+  return true;
+}
+
+static void null_draw(Renderer_t *renderer, const GameData_t *game) {
+  (void)game;
+  renderer->frames++;
+}
+
+static int null_read_key(Renderer_t *renderer) {
+  (void)renderer;
+  return NO_KEY;
+}
+
+static void null_cleanup(Renderer_t *renderer) { (void)renderer; }
+
+/**
+ * @brief Создает вывод, который ничего не рисует.
+ *
+ * Нужен для безголовых прогонов: игра идет так же, как с настоящим
+ * выводом, но стоимость отрисовки равна нулю, что дает точку отсчета
+ * для сравнения остальных способов вывода.
+ * @param renderer Структура, в которую записывается вывод.
+ */
+void null_renderer(Renderer_t *renderer) {
+  *renderer = (Renderer_t){"null",        null_init, null_draw,
+                           null_read_key, null_cleanup, NULL, 0, 0, {0}};
+}
+
+static void fill(Offscreen_t *screen, int y, int x, int width, char symbol,
+                 uint8_t color) {
+  memset(&screen->text[y][x], symbol, (size_t)width);
+  memset(&screen->color[y][x], color, (size_t)width);
+}
+
+static void put_text(Offscreen_t *screen, int y, int x, const char *text) {
+  size_t length = strlen(text);
+  memcpy(&screen->text[y][x], text, length);
+  memset(&screen->color[y][x], 0, length);
+}
+
+static void put_number(Offscreen_t *screen, int y, int x, const char *label,
+                       int value) {
+  char text[INFO_WINDOW_WIDTH];
+  snprintf(text, sizeof(text), "%s%-9d", label, value);
+  put_text(screen, y, x, text);
+}
+
+/**
+ * @brief Рисует рамку окна теми же символами, что и ACS-линии ncurses.
+ */
+static void draw_box(Offscreen_t *screen, int top, int left, int width) {
+  fill(screen, top, left, width, '-', 0);
+  fill(screen, top + WINDOW_HEIGHT - 1, left, width, '-', 0);
+  for (int y = top; y < top + WINDOW_HEIGHT; y++) {
+    screen->text[y][left] = screen->text[y][left + width - 1] = '|';
+  }
+  screen->text[top][left] = screen->text[top][left + width - 1] = '+';
+  screen->text[top + WINDOW_HEIGHT - 1][left] =
+      screen->text[top + WINDOW_HEIGHT - 1][left + width - 1] = '+';
+}
+
+static bool offscreen_init(Renderer_t *renderer) {
+  Offscreen_t *screen = renderer->state;
+  memset(screen->text, ' ', sizeof(screen->text));
+  memset(screen->color, 0, sizeof(screen->color));
+  return true;
+}
+
+/**
+ * @brief Растеризует кадр целиком в буфер символов и цветов в памяти.
+ *
+ * Раскладка совпадает с выводом ncurses: клетка поля занимает два
+ * столбца, цвет клетки — индекс цвета фигуры (0 — пусто), тень фигуры —
+ * символы "[]" без цвета.
+ */
+static void offscreen_draw(Renderer_t *renderer, const GameData_t *game) {
+  Offscreen_t *screen = renderer->state;
+  Frame_t frame;
+  compose_frame(game, &renderer->ghost, &frame);
+
+  draw_box(screen, BOARD_WINDOW_Y, BOARD_WINDOW_X, BOARD_WINDOW_WIDTH);
+  draw_box(screen, INFO_WINDOW_Y, INFO_WINDOW_X, INFO_WINDOW_WIDTH);
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    for (int x = 0; x < BOARD_WIDTH; x++) {
+      int top = BOARD_WINDOW_Y + 1 + y, left = BOARD_WINDOW_X + 1 + x * 2;
+      if (frame.cells[y][x] == FRAME_GHOST) {
+        put_text(screen, top, left, "[]");
+      } else {
+        fill(screen, top, left, 2, ' ', frame.cells[y][x]);
+      }
+    }
+  }
+
+  put_number(screen, INFO_WINDOW_Y + 2, INFO_WINDOW_X + 2, "Score: ",
+             frame.score);
+  put_number(screen, INFO_WINDOW_Y + 3, INFO_WINDOW_X + 2, "High:  ",
+             frame.high_score);
+  put_number(screen, INFO_WINDOW_Y + 4, INFO_WINDOW_X + 2, "Level: ",
+             frame.level);
+  put_text(screen, INFO_WINDOW_Y + 7, INFO_WINDOW_X + 2, "Next:");
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      uint8_t color = FIGURES[frame.next_piece][i][j]
+                          ? (uint8_t)(frame.next_piece + 1)
+                          : 0;
+      fill(screen, INFO_WINDOW_Y + PREVIEW_ROW + i,
+           INFO_WINDOW_X + PREVIEW_COL + j * 2, 2, ' ', color);
+    }
+  }
+  for (int k = 0; k < FRAME_QUEUE; k++) {
+    int piece = frame.queue[k];
+    for (int i = 1; i < 3; i++) {
+      for (int j = 0; j < 4; j++) {
+        uint8_t color =
+            piece >= 0 && FIGURES[piece][i][j] ? (uint8_t)(piece + 1) : 0;
+        fill(screen, INFO_WINDOW_Y + QUEUE_ROW + k * QUEUE_STEP + i - 1,
+             INFO_WINDOW_X + PREVIEW_COL + j * 2, 2, ' ', color);
+      }
+    }
+  }
+
+  const char *message = overlay_message(frame.overlay);
+  if (message) {
+    int length = (int)strlen(message);
+    put_text(screen, BOARD_WINDOW_Y + OVERLAY_ROW + 1,
+             BOARD_WINDOW_X + (BOARD_WINDOW_WIDTH - length) / 2, message);
+  }
+  renderer->frames++;
+  renderer->bytes += sizeof(*screen);
+}
+
+/**
+ * @brief Создает вывод в буфер в памяти.
+ *
+ * Каждый кадр растеризуется заново целиком; в renderer->bytes
+ * учитывается объем записанного буфера.
+ * @param renderer Структура, в которую записывается вывод.
+ * @param screen Буфер экрана; остается во владении вызывающего.
+ */
+void offscreen_renderer(Renderer_t *renderer, Offscreen_t *screen) {
+  *renderer = (Renderer_t){"offscreen",   offscreen_init, offscreen_draw,
+                           null_read_key, null_cleanup,   screen,
+                           0,             0,              {0}};
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef GUI_CLI_RENDERER_H
+#define GUI_CLI_RENDERER_H
+
+#include <stddef.h>
+
+#include "gui/cli/frame.h"
+
+typedef struct Renderer Renderer_t;
+
+struct Renderer {
+  const char *name;
+  bool (*init)(Renderer_t *renderer);
+  void (*draw)(Renderer_t *renderer, const GameData_t *game);
+  int (*read_key)(Renderer_t *renderer);
+  void (*cleanup)(Renderer_t *renderer);
+  void *state;
+  long frames;
+  size_t bytes;
+  GhostCache_t ghost;
+};
+
+typedef struct {
+  char text[SCREEN_HEIGHT][SCREEN_WIDTH];
+  uint8_t color[SCREEN_HEIGHT][SCREEN_WIDTH];
+} Offscreen_t;
+
+void null_renderer(Renderer_t *renderer);
+void offscreen_renderer(Renderer_t *renderer, Offscreen_t *screen);
+
+#endif
\ No newline at end of file
@@ -2,52 +2,97 @@
 
 #include <string.h>
 
-static WINDOW *win_board;
-static WINDOW *win_info;
-
-void init_terminal() {
-  initscr();
+static bool init_terminal(Renderer_t *renderer) {
+  NcursesView_t *view = renderer->state;
+  if (!view) return false;
+  if (view->output) {
+    // Вывод в файл (для замеров): терминал берется из TERM, ввода нет
+    const char *term = getenv("TERM");
+    view->input = fopen("/dev/null", "r");
+    if (!view->input) return false;
+    view->screen = newterm(term ? term : "xterm", view->output, view->input);
+    if (!view->screen) {
+      fclose(view->input);
+      return false;
+    }
+  } else {
+    initscr();
+  }
   cbreak();
   noecho();
   curs_set(FALSE);
-  keypad(stdscr, TRUE);
-  nodelay(stdscr, TRUE);
 
   start_color();
   init_colors();
-
-  win_board = newwin(BOARD_HEIGHT + 2, BOARD_WIDTH * 2 + 2, 1, 1);
-  win_info = newwin(BOARD_HEIGHT + 2, 20, 1, BOARD_WIDTH * 2 + 4);
-
-  wbkgd(win_board, COLOR_PAIR(8));
-  wbkgd(win_info, COLOR_PAIR(8));
+  // getch обновляет stdscr, если тот ни разу не выводился, и затирает им
+  // окна; после этого вызова stdscr чист и ввод экран не трогает
+  refresh();
+
+  view->win_board = newwin(WINDOW_HEIGHT, BOARD_WINDOW_WIDTH, BOARD_WINDOW_Y,
+                           BOARD_WINDOW_X);
+  view->win_info = newwin(WINDOW_HEIGHT, INFO_WINDOW_WIDTH, INFO_WINDOW_Y,
+                          INFO_WINDOW_X);
+
+  // Клавиши читаются через окно поля: wgetch обновляет только его, и
+  // экран всегда совпадает с теневым кадром shown
+  keypad(view->win_board, TRUE);
+  nodelay(view->win_board, TRUE);
+
+  wbkgd(view->win_board, COLOR_PAIR(8));
+  wbkgd(view->win_info, COLOR_PAIR(8));
+
+  // Рамки и подписи не меняются: они рисуются один раз
+  box(view->win_board, 0, 0);
+  box(view->win_info, 0, 0);
+  mvwprintw(view->win_info, 7, 2, "Next:");
+  invalidate_frame(&view->shown);
+  return true;
 }
 
-void cleanup_terminal() {
-  delwin(win_board);
-  delwin(win_info);
+static void cleanup_terminal(Renderer_t *renderer) {
+  NcursesView_t *view = renderer->state;
+  delwin(view->win_board);
+  delwin(view->win_info);
   endwin();
+  if (view->screen) {
+    delscreen(view->screen);
+    fclose(view->input);
+  }
+  free(view);
+  renderer->state = NULL;
 }
 
-void draw_game(const GameData_t *game) {
-  werase(win_board);
-  werase(win_info);
-
-  box(win_board, 0, 0);
-  box(win_info, 0, 0);
-
-  draw_board(game);
-  draw_info_panel(game);
+static void draw_game(Renderer_t *renderer, const GameData_t *game) {
+  NcursesView_t *view = renderer->state;
+  Frame_t frame;
+  compose_frame(game, &renderer->ghost, &frame);
 
-  if (game->info.pause) {
-    draw_overlay("PAUSE");
-  } else if (game->state == GameOver) {
-    draw_overlay("GAME OVER");
+  bool board_changed = draw_board(view, &frame);
+  bool info_changed = draw_info_panel(view, &frame);
+  if (frame.overlay != view->shown.overlay || board_changed) {
+    const char *message = overlay_message(frame.overlay);
+    if (message) draw_overlay(view, message);
   }
+  view->shown = frame;
+  renderer->frames++;
+
+  // Без изменений терминалу ничего не отправляется
+  if (board_changed) wnoutrefresh(view->win_board);
+  if (info_changed) wnoutrefresh(view->win_info);
+  if (board_changed || info_changed) doupdate();
+  if (view->output) renderer->bytes = (size_t)ftell(view->output);
+}
+
+static int read_key(Renderer_t *renderer) {
+  NcursesView_t *view = renderer->state;
+  return wgetch(view->win_board);
+}
 
-  wnoutrefresh(win_board);
-  wnoutrefresh(win_info);
-  doupdate();
+void ncurses_renderer(Renderer_t *renderer, FILE *output) {
+  NcursesView_t *view = calloc(1, sizeof(NcursesView_t));
+  if (view) view->output = output;
+  *renderer = (Renderer_t){"ncurses", init_terminal, draw_game, read_key,
+                           cleanup_terminal, view, 0, 0, {0}};
 }
 
 void init_colors() {
@@ -62,60 +107,86 @@ void init_colors() {
   init_pair(8, COLOR_WHITE, COLOR_BLACK);
 }
 
-void draw_board(const GameData_t *game) {
+static void draw_cell(WINDOW *win, int y, int x, int color) {
+  // Тень фигуры рисуется скобками на черном фоне
+  int pair = color && color != FRAME_GHOST ? color : 8;
+  wattron(win, COLOR_PAIR(pair));
+  mvwaddstr(win, y, x, color == FRAME_GHOST ? "[]" : "  ");
+  wattroff(win, COLOR_PAIR(pair));
+}
+
+bool draw_board(NcursesView_t *view, const Frame_t *frame) {
+  const Frame_t *shown = &view->shown;
+  uint32_t dirty = frame_dirty_rows(shown, frame);
+  // Надпись закрывала часть строки: после ее снятия строка рисуется целиком
+  bool overlay_removed =
+      shown->overlay != OverlayNone && frame->overlay != shown->overlay;
+  if (overlay_removed) dirty |= 1u << OVERLAY_ROW;
+
   for (int y = 0; y < BOARD_HEIGHT; y++) {
+    if (!(dirty >> y & 1)) continue;
+    bool full_row = overlay_removed && y == OVERLAY_ROW;
     for (int x = 0; x < BOARD_WIDTH; x++) {
-      if (game->board[y][x] != 0) {
-        wattron(win_board, COLOR_PAIR(game->board[y][x]));
-        mvwprintw(win_board, y + 1, x * 2 + 1, "  ");
-        wattroff(win_board, COLOR_PAIR(game->board[y][x]));
+      if (full_row || frame->cells[y][x] != shown->cells[y][x]) {
+        draw_cell(view->win_board, y + 1, x * 2 + 1, frame->cells[y][x]);
       }
     }
   }
+  return dirty != 0 || frame->overlay != shown->overlay;
+}
+
+bool draw_info_panel(NcursesView_t *view, const Frame_t *frame) {
+  const Frame_t *shown = &view->shown;
+  WINDOW *win_info = view->win_info;
+  bool changed = false;
+  wattron(win_info, COLOR_PAIR(8));
+  // Ширина поля фиксирована, чтобы новое число затирало старое целиком
+  if (frame->score != shown->score) {
+    mvwprintw(win_info, 2, 2, "Score: %-9d", frame->score);
+    changed = true;
+  }
+  if (frame->high_score != shown->high_score) {
+    mvwprintw(win_info, 3, 2, "High:  %-9d", frame->high_score);
+    changed = true;
+  }
+  if (frame->level != shown->level) {
+    mvwprintw(win_info, 4, 2, "Level: %-9d", frame->level);
+    changed = true;
+  }
+  wattroff(win_info, COLOR_PAIR(8));
 
-  if (game->state == Moving || game->state == Shifting) {
-    wattron(win_board, COLOR_PAIR(game->current_piece.color_index));
+  if (frame->next_piece != shown->next_piece) {
+    int next_color = frame->next_piece + 1;
     for (int i = 0; i < 4; i++) {
       for (int j = 0; j < 4; j++) {
-        if (game->current_piece.shape[i][j] && game->current_piece.y + i >= 0) {
-          mvwprintw(win_board, game->current_piece.y + i + 1,
-                    (game->current_piece.x + j) * 2 + 1, "  ");
-        }
+        draw_cell(win_info, i + PREVIEW_ROW, j * 2 + PREVIEW_COL,
+                  FIGURES[frame->next_piece][i][j] ? next_color : 0);
       }
     }
-    wattroff(win_board, COLOR_PAIR(game->current_piece.color_index));
+    changed = true;
   }
-}
-
-void draw_info_panel(const GameData_t *game) {
-  wattron(win_info, COLOR_PAIR(8));
-
-  mvwprintw(win_info, 2, 2, "Score: %d", game->info.score);
-  mvwprintw(win_info, 3, 2, "High:  %d", game->info.high_score);
-  mvwprintw(win_info, 4, 2, "Level: %d", game->info.level);
-
-  mvwprintw(win_info, 7, 2, "Next:");
-
-  int next_color = game->next_piece_index + 1;
-  wattron(win_info, COLOR_PAIR(next_color));
-  for (int i = 0; i < 4; i++) {
-    for (int j = 0; j < 4; j++) {
-      if (FIGURES[game->next_piece_index][i][j]) {
-        mvwprintw(win_info, i + 9, j * 2 + 5, "  ");
+  for (int k = 0; k < FRAME_QUEUE; k++) {
+    int piece = frame->queue[k];
+    if (piece == shown->queue[k]) continue;
+    // У всех фигур в начальном повороте заняты только строки 1 и 2
+    for (int i = 1; i < 3; i++) {
+      for (int j = 0; j < 4; j++) {
+        draw_cell(win_info, QUEUE_ROW + k * QUEUE_STEP + i - 1,
+                  j * 2 + PREVIEW_COL,
+                  piece >= 0 && FIGURES[piece][i][j] ? piece + 1 : 0);
       }
     }
+    changed = true;
   }
-  wattroff(win_info, COLOR_PAIR(next_color));
-
-  wattroff(win_info, COLOR_PAIR(8));
+  return changed;
 }
 
-void draw_overlay(const char *message) {
+void draw_overlay(NcursesView_t *view, const char *message) {
   int len = strlen(message);
-  int y = (BOARD_HEIGHT + 2) / 2 - 1;
-  int x = (BOARD_WIDTH * 2 + 2 - len) / 2;
+  int y = OVERLAY_ROW + 1;
+  int x = (BOARD_WINDOW_WIDTH - len) / 2;
 
-  wattron(win_board, COLOR_PAIR(8));
-  mvwprintw(win_board, y, x, message);
-  wattroff(win_board, COLOR_PAIR(8));
+  wattron(view->win_board, COLOR_PAIR(8));
+  mvwprintw(view->win_board, y, x, message);
+  wattroff(view->win_board, COLOR_PAIR(8));
 }
\ No newline at end of file
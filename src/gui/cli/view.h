@@ -4,15 +4,23 @@
 #include <ncurses.h>
 
 #include "brickgame/tetris/tetris.h"
+#include "gui/cli/frame.h"
+#include "gui/cli/renderer.h"
 
-void init_terminal();
-void cleanup_terminal();
+typedef struct {
+  SCREEN *screen;
+  FILE *input;
+  FILE *output;
+  WINDOW *win_board;
+  WINDOW *win_info;
+  Frame_t shown;
+} NcursesView_t;
 
-void draw_game(const GameData_t *game);
+void ncurses_renderer(Renderer_t *renderer, FILE *output);
 
 void init_colors();
-void draw_board(const GameData_t *game);
-void draw_info_panel(const GameData_t *game);
-void draw_overlay(const char *message);
+bool draw_board(NcursesView_t *view, const Frame_t *frame);
+bool draw_info_panel(NcursesView_t *view, const Frame_t *frame);
+void draw_overlay(NcursesView_t *view, const char *message);
 
 #endif
\ No newline at end of file
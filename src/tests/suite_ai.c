@@ -0,0 +1,168 @@
+#include "brickgame/tetris/ai.h"
+#include "tests/suites.h"
+
+#define AI_TEST_PIECES 300
+
+// --- Утилита для тестов: запускает игру и ждет первую фигуру ---
+static void start_game(GameData_t *game, uint64_t seed, int previews) {
+  initialize_game_core(game, 0, seed);
+  set_settle_transitions(game, true);
+  set_preview_length(game, previews);
+  apply_user_action(game, ActionStart);
+  update_game_state(game);
+}
+
+// --- Выполняет задачи в обратном порядке на "разных потоках" ---
+static void reverse_tasks(void *runner, int threads, int64_t task_count,
+                          AiTaskFn_t fn, void *context) {
+  (void)runner;
+  for (int64_t task = task_count - 1; task >= 0; task--) {
+    fn(context, (int)(task % threads), task);
+  }
+}
+
+//----------------------------------------------------------------------------
+// --- Тесты оценки поля ---
+
+START_TEST(test_ai_features) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 31);
+  // Столбец 0 высотой 3 с дыркой, столбец 1 высотой 1
+  set_board_cell(&game, 0, 17, 1);
+  set_board_cell(&game, 0, 19, 1);
+  set_board_cell(&game, 1, 19, 2);
+
+  AiFeatures_t features;
+  ai_features(&game, &features);
+  ck_assert_int_eq(features.height, 4);
+  ck_assert_int_eq(features.holes, 1);
+  ck_assert_int_eq(features.bumpiness, 3);
+
+  AiWeights_t weights = {1, 10, 100, 1000};
+  ck_assert_int_eq(ai_evaluate(&game, &weights, 2), 4 + 20 + 100 + 3000);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// --- Тесты лучевого поиска ---
+
+START_TEST(test_ai_search_fills_well) {
+  GameData_t game;
+  start_game(&game, 32, 1);
+  // Четыре строки с колодцем в последнем столбце
+  for (int y = 16; y < BOARD_HEIGHT; y++) {
+    for (int x = 0; x < BOARD_WIDTH - 1; x++) set_board_cell(&game, x, y, 3);
+  }
+  game.current_piece = (CurrentPiece_t){0, 0, SPAWN_X, SPAWN_Y, 1};
+
+  AiPlayer_t *ai = ai_create(8, 1, 1);
+  ck_assert_ptr_nonnull(ai);
+  CurrentPiece_t best;
+  ck_assert(ai_search(ai, &game, &best));
+  game.current_piece = best;
+  imprint_piece_to_board(&game);
+  process_scoring_and_levelup(&game);
+  ck_assert_int_eq(game.info.score, 1500);
+  for (int x = 0; x < BOARD_WIDTH; x++) ck_assert_int_eq(game.heights[x], 0);
+  ai_destroy(ai);
+}
+END_TEST
+
+START_TEST(test_ai_search_independent_of_task_order) {
+  GameData_t game;
+  start_game(&game, 33, 4);
+  AiPlayer_t *serial = ai_create(8, 4, 1);
+  AiPlayer_t *parallel = ai_create(8, 4, 3);
+  ck_assert_ptr_nonnull(serial);
+  ck_assert_ptr_nonnull(parallel);
+  parallel->parallel = reverse_tasks;
+
+  for (int i = 0; i < 20 && game.state == Moving; i++) {
+    CurrentPiece_t first, second;
+    ck_assert(ai_search(serial, &game, &first));
+    ck_assert(ai_search(parallel, &game, &second));
+    ck_assert_mem_eq(&first, &second, sizeof(first));
+    game.current_piece = first;
+    game.state = Attaching;
+    update_game_state(&game);
+  }
+  ck_assert_int_eq(game.state, Moving);
+  ai_destroy(serial);
+  ai_destroy(parallel);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// --- Тесты автоигрока ---
+
+START_TEST(test_ai_plays_long_game) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 34);
+  set_settle_transitions(&game, true);
+  set_preview_length(&game, 3);
+  AiPlayer_t *ai = ai_create(AI_DEFAULT_WIDTH, AI_DEFAULT_DEPTH, 1);
+  ck_assert_ptr_nonnull(ai);
+
+  // Тот же цикл, что в безголовом режиме tetris -H
+  while (game.state != GameOver && game.piece_count < AI_TEST_PIECES) {
+    UserAction_t action;
+    while ((action = ai_next_action(ai, &game)) != ActionNone) {
+      apply_user_action(&game, action);
+    }
+    advance_game(&game, next_event_tick(&game) - game.timer.tick + 1);
+  }
+  ck_assert_int_eq(game.state, Moving);
+  ck_assert_int_gt(game.info.score, 0);
+  ck_assert_int_eq(ai->plans, game.piece_count - 1);
+  ai_destroy(ai);
+}
+END_TEST
+
+START_TEST(test_ai_replans_after_interference) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 35);
+  set_settle_transitions(&game, true);
+  AiPlayer_t *ai = ai_create(4, 2, 1);
+  ck_assert_ptr_nonnull(ai);
+
+  ck_assert_int_eq(ai_next_action(ai, &game), ActionStart);
+  apply_user_action(&game, ActionStart);
+  ck_assert_int_eq(ai_next_action(ai, &game), ActionNone);
+  update_game_state(&game);
+
+  // Фигура опустилась на две строки раньше первого хода (например, цикл
+  // догонял тики): путь строится заново из нового положения
+  ck_assert_int_ne(ai_next_action(ai, &game), ActionNone);
+  ck_assert_int_eq(ai->plans, 1);
+  game.current_piece.y += 2;
+  UserAction_t action;
+  while ((action = ai_next_action(ai, &game)) != ActionNone) {
+    apply_user_action(&game, action);
+  }
+  ck_assert_int_eq(ai->plans, 2);
+  ck_assert_int_eq(game.state, Attaching);
+  ai_destroy(ai);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// Создание тестового набора для автоигрока
+Suite *ai_suite_create(void) {
+  Suite *s = suite_create("AI");
+
+  TCase *tc_eval = tcase_create("Evaluation");
+  tcase_add_test(tc_eval, test_ai_features);
+  suite_add_tcase(s, tc_eval);
+
+  TCase *tc_search = tcase_create("Search");
+  tcase_add_test(tc_search, test_ai_search_fills_well);
+  tcase_add_test(tc_search, test_ai_search_independent_of_task_order);
+  suite_add_tcase(s, tc_search);
+
+  TCase *tc_player = tcase_create("Player");
+  tcase_add_test(tc_player, test_ai_plays_long_game);
+  tcase_add_test(tc_player, test_ai_replans_after_interference);
+  suite_add_tcase(s, tc_player);
+
+  return s;
+}
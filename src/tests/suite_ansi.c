@@ -0,0 +1,179 @@
+#include <stdio.h>
+
+#include "gui/cli/ansi.h"
+#include "tests/suites.h"
+
+#define SCREEN_ROWS 24
+#define SCREEN_COLS 48
+
+// --- Утилита для тестов: минимальный эмулятор терминала ---
+// Понимает только то, что выводит ansi.c: перемещения курсора, цвет фона
+// и печатные символы. Для каждой позиции хранит символ и цвет фона.
+typedef struct {
+  char text[SCREEN_ROWS + 1][SCREEN_COLS + 1];
+  int background[SCREEN_ROWS + 1][SCREEN_COLS + 1];
+  int row, col, color;
+} Screen_t;
+
+static void screen_feed(Screen_t *screen, const char *bytes, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    if (bytes[i] == '\033' && bytes[i + 1] == '(') {
+      i += 2;
+      continue;
+    }
+    if (bytes[i] != '\033') {
+      ck_assert(screen->row >= 1 && screen->row <= SCREEN_ROWS);
+      ck_assert(screen->col >= 1 && screen->col <= SCREEN_COLS);
+      screen->text[screen->row][screen->col] = bytes[i];
+      screen->background[screen->row][screen->col] = screen->color;
+      screen->col++;
+      continue;
+    }
+    ck_assert_int_eq(bytes[++i], '[');
+    int params[4] = {0}, count = 0;
+    bool question = bytes[i + 1] == '?';
+    if (question) i++;
+    while (++i < length && ((bytes[i] >= '0' && bytes[i] <= '9') ||
+                            bytes[i] == ';')) {
+      if (bytes[i] == ';')
+        count++;
+      else
+        params[count] = params[count] * 10 + (bytes[i] - '0');
+    }
+    int n = params[0] ? params[0] : 1;
+    switch (bytes[i]) {
+      case 'H':
+        screen->row = n;
+        screen->col = params[1] ? params[1] : 1;
+        break;
+      case 'A':
+        screen->row -= n;
+        break;
+      case 'B':
+        screen->row += n;
+        break;
+      case 'C':
+        screen->col += n;
+        break;
+      case 'D':
+        screen->col -= n;
+        break;
+      case 'm':
+        for (int k = 0; k <= count; k++) {
+          if (params[k] >= 40 && params[k] <= 47) screen->color = params[k];
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+static void assert_screen_shows(const Screen_t *screen, const Frame_t *frame) {
+  static const int COLORS[8] = {40, 46, 43, 45, 47, 44, 42, 41};
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    // Строку с надписью PAUSE / GAME OVER клетки закрывает текст
+    if (frame->overlay != OverlayNone && y == OVERLAY_ROW) continue;
+    for (int x = 0; x < BOARD_WIDTH; x++) {
+      int color = COLORS[frame->cells[y][x]];
+      ck_assert_int_eq(screen->background[3 + y][3 + x * 2], color);
+      ck_assert_int_eq(screen->background[3 + y][4 + x * 2], color);
+    }
+  }
+  char score[16];
+  snprintf(score, sizeof(score), "%d", frame->score);
+  ck_assert_mem_eq(&screen->text[4][34], score, strlen(score));
+  const char *message = overlay_message(frame->overlay);
+  if (message) {
+    size_t length = strlen(message);
+    int col = 2 + (BOARD_WINDOW_WIDTH - (int)length) / 2;
+    ck_assert_mem_eq(&screen->text[12][col], message, length);
+  }
+}
+
+static void play_random_frames(AnsiRenderer_t *renderer, Screen_t *screen,
+                               int steps) {
+  static const UserAction_t ACTIONS[] = {ActionMoveLeft, ActionMoveRight,
+                                         ActionRotate, ActionMoveDown,
+                                         ActionNone};
+  GameData_t game;
+  initialize_game_core(&game, 0, 21);
+  apply_user_action(&game, ActionStart);
+  unsigned seed = 5;
+  Frame_t frame;
+  for (int i = 0; i < steps && game.state != GameOver; i++) {
+    seed = seed * 1103515245u + 12345u;
+    apply_user_action(&game, ACTIONS[(seed >> 16) % 5]);
+    update_game_state(&game);
+    compose_frame(&game, NULL, &frame);
+    ansi_render_frame(renderer, &frame);
+    screen_feed(screen, renderer->buffer, renderer->length);
+    ansi_renderer_consume(renderer);
+  }
+  // Отложенные бюджетом строки дорисовываются следующими кадрами
+  for (int i = 0; i < 100 && ansi_render_frame(renderer, &frame) > 0; i++) {
+    screen_feed(screen, renderer->buffer, renderer->length);
+    ansi_renderer_consume(renderer);
+  }
+  assert_screen_shows(screen, &frame);
+}
+
+//----------------------------------------------------------------------------
+// --- Тесты вывода кадров последовательностями ANSI ---
+
+START_TEST(test_ansi_output_reproduces_frames) {
+  static AnsiRenderer_t renderer;
+  static Screen_t screen;
+  memset(&screen, 0, sizeof(screen));
+  ansi_renderer_init(&renderer, 0);
+  play_random_frames(&renderer, &screen, 3000);
+  ck_assert_int_eq(renderer.deferred_frames, 0);
+}
+END_TEST
+
+START_TEST(test_ansi_budget_defers_rows) {
+  static AnsiRenderer_t renderer;
+  static Screen_t screen;
+  memset(&screen, 0, sizeof(screen));
+  ansi_renderer_init(&renderer, 48);
+  play_random_frames(&renderer, &screen, 3000);
+  ck_assert_int_gt(renderer.deferred_frames, 0);
+}
+END_TEST
+
+START_TEST(test_ansi_unchanged_frame_is_empty) {
+  static AnsiRenderer_t renderer;
+  GameData_t game;
+  initialize_game_core(&game, 0, 8);
+  apply_user_action(&game, ActionStart);
+  update_game_state(&game);
+
+  Frame_t frame;
+  compose_frame(&game, NULL, &frame);
+  ansi_renderer_init(&renderer, 0);
+  ck_assert_uint_gt(ansi_render_frame(&renderer, &frame), 0);
+  ansi_renderer_consume(&renderer);
+  ck_assert_uint_eq(ansi_render_frame(&renderer, &frame), 0);
+
+  // Сдвиг фигуры на клетку — несколько десятков байт, а не весь экран
+  apply_user_action(&game, ActionMoveRight);
+  compose_frame(&game, NULL, &frame);
+  size_t bytes = ansi_render_frame(&renderer, &frame);
+  ck_assert_uint_gt(bytes, 0);
+  ck_assert_uint_lt(bytes, 80);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// Создание тестового набора для вывода ANSI
+Suite *ansi_suite_create(void) {
+  Suite *s = suite_create("Ansi");
+
+  TCase *tc_ansi = tcase_create("Ansi");
+  tcase_add_test(tc_ansi, test_ansi_output_reproduces_frames);
+  tcase_add_test(tc_ansi, test_ansi_budget_defers_rows);
+  tcase_add_test(tc_ansi, test_ansi_unchanged_frame_is_empty);
+  suite_add_tcase(s, tc_ansi);
+
+  return s;
+}
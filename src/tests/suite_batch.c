@@ -0,0 +1,187 @@
+#include "brickgame/tetris/batch.h"
+#include "tests/suites.h"
+
+#define LOCKSTEP_STEPS 3000
+
+static const BatchKernel_t KERNELS[] = {BatchKernelScalar, BatchKernelSSE2,
+                                        BatchKernelAVX2};
+
+// --- Утилита для тестов: детерминированный генератор для действий ---
+static unsigned next_random(unsigned *state) {
+  *state = *state * 1103515245u + 12345u;
+  return (*state >> 16) & 0x7FFF;
+}
+
+// --- Утилита для тестов: сравнивает две игры поле за полем ---
+static void assert_games_equal(const GameData_t *a, const GameData_t *b) {
+  ck_assert_int_eq(a->state, b->state);
+  ck_assert_int_eq(memcmp(a->rows, b->rows, sizeof(a->rows)), 0);
+  ck_assert_int_eq(memcmp(a->board, b->board, sizeof(a->board)), 0);
+  ck_assert_int_eq(a->next_piece_index, b->next_piece_index);
+  ck_assert_int_eq(a->info.score, b->info.score);
+  ck_assert_int_eq(a->info.high_score, b->info.high_score);
+  ck_assert_int_eq(a->info.level, b->info.level);
+  ck_assert_int_eq(a->info.pause, b->info.pause);
+  ck_assert_int_eq(a->current_piece.piece, b->current_piece.piece);
+  ck_assert_int_eq(a->current_piece.rotation, b->current_piece.rotation);
+  ck_assert_int_eq(a->current_piece.x, b->current_piece.x);
+  ck_assert_int_eq(a->current_piece.y, b->current_piece.y);
+  ck_assert_int_eq(a->current_piece.color_index,
+                   b->current_piece.color_index);
+  ck_assert_int_eq(a->timer.tick, b->timer.tick);
+  ck_assert_int_eq(a->timer.next_shift_tick, b->timer.next_shift_tick);
+  ck_assert_int_eq(a->piece_count, b->piece_count);
+  ck_assert_uint_eq(a->generator.rng.state, b->generator.rng.state);
+}
+
+// --- Утилита для тестов: случайное поле с "рваной" поверхностью ---
+static void fill_random_board(GameData_t *game, unsigned *seed) {
+  initialize_game_core(game, 0, 1);
+  for (int y = 8; y < BOARD_HEIGHT; y++) {
+    for (int x = 0; x < BOARD_WIDTH; x++) {
+      if (next_random(seed) % 3) set_board_cell(game, x, y, 1 + x % 7);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// --- Тесты векторных ядер ---
+
+START_TEST(test_batch_collisions_match_scalar_engine) {
+  enum { LANES = 37 };
+  GameBatch_t *batch = batch_create(LANES);
+  ck_assert_ptr_nonnull(batch);
+
+  unsigned seed = 17;
+  GameData_t games[LANES];
+  for (int lane = 0; lane < LANES; lane++) {
+    fill_random_board(&games[lane], &seed);
+    games[lane].current_piece.piece = next_random(&seed) % PIECE_COUNT;
+    batch_import_game(batch, lane, &games[lane]);
+  }
+
+  int32_t lanes[LANES];
+  for (int lane = 0; lane < LANES; lane++) lanes[lane] = lane;
+
+  for (int round = 0; round < 200; round++) {
+    for (int lane = 0; lane < LANES; lane++) {
+      CurrentPiece_t *piece = &games[lane].current_piece;
+      piece->rotation = next_random(&seed) % ROTATION_COUNT;
+      piece->x = (int)(next_random(&seed) % 14) - 3;
+      piece->y = (int)(next_random(&seed) % 24) - 3;
+      batch->cand_x[lane] = (int8_t)piece->x;
+      batch->cand_y[lane] = (int8_t)piece->y;
+      batch->cand_rotation[lane] = (int8_t)piece->rotation;
+    }
+    for (size_t k = 0; k < sizeof(KERNELS) / sizeof(KERNELS[0]); k++) {
+      batch_set_kernel(batch, KERNELS[k]);
+      batch_check_collisions(batch, lanes, LANES);
+      for (int lane = 0; lane < LANES; lane++) {
+        ck_assert_int_eq(batch->hit[lane], check_collision(&games[lane]));
+      }
+    }
+  }
+  batch_destroy(batch);
+}
+END_TEST
+
+START_TEST(test_batch_full_rows_all_kernels) {
+  GameBatch_t *batch = batch_create(3);
+  ck_assert_ptr_nonnull(batch);
+
+  GameData_t game;
+  initialize_game_core(&game, 0, 1);
+  int full_rows[] = {0, 7, 15, 16, 19};
+  uint32_t expected = 0;
+  for (size_t i = 0; i < sizeof(full_rows) / sizeof(full_rows[0]); i++) {
+    for (int x = 0; x < BOARD_WIDTH; x++) {
+      set_board_cell(&game, x, full_rows[i], 2);
+    }
+    expected |= 1u << full_rows[i];
+  }
+  // Почти полная строка не должна считаться заполненной
+  for (int x = 1; x < BOARD_WIDTH; x++) set_board_cell(&game, x, 18, 3);
+  batch_import_game(batch, 1, &game);
+
+  for (size_t k = 0; k < sizeof(KERNELS) / sizeof(KERNELS[0]); k++) {
+    batch_set_kernel(batch, KERNELS[k]);
+    ck_assert_uint_eq(batch_full_rows(batch, 0), 0);
+    ck_assert_uint_eq(batch_full_rows(batch, 1), expected);
+    ck_assert_uint_eq(batch_full_rows(batch, 2), 0);
+  }
+  batch_destroy(batch);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// --- Тесты пошагового совпадения с обычным движком ---
+
+static GameData_t snapshots[LOCKSTEP_STEPS];
+static UserAction_t recorded[LOCKSTEP_STEPS];
+
+static void run_lockstep(BatchKernel_t kernel) {
+  static const UserAction_t ACTIONS[] = {
+      ActionNone,     ActionNone,      ActionNone,   ActionNone,
+      ActionMoveLeft, ActionMoveRight, ActionRotate, ActionMoveDown,
+      ActionPause,    ActionStart};
+  unsigned seed = 99;
+  GameData_t game;
+
+  initialize_game_core(&game, 0, 7);
+  int steps = 0;
+  for (; steps < LOCKSTEP_STEPS && game.state != GameOver; steps++) {
+    recorded[steps] =
+        steps == 0 ? ActionStart : ACTIONS[next_random(&seed) % 10];
+    apply_user_action(&game, recorded[steps]);
+    update_game_state(&game);
+    snapshots[steps] = game;
+  }
+
+  // У игры с индексом 0 то же начальное значение, что и у обычной игры
+  GameBatch_t *batch = batch_create(1);
+  ck_assert_ptr_nonnull(batch);
+  batch_set_kernel(batch, kernel);
+  batch_reset(batch, 0, 7);
+  for (int i = 0; i < steps; i++) {
+    GameData_t exported;
+    batch_step(batch, &recorded[i]);
+    batch_export_game(batch, 0, &exported);
+    assert_games_equal(&exported, &snapshots[i]);
+  }
+  batch_destroy(batch);
+}
+
+START_TEST(test_batch_lockstep_scalar) { run_lockstep(BatchKernelScalar); }
+END_TEST
+
+START_TEST(test_batch_lockstep_sse2) { run_lockstep(BatchKernelSSE2); }
+END_TEST
+
+START_TEST(test_batch_lockstep_avx2) { run_lockstep(BatchKernelAVX2); }
+END_TEST
+
+START_TEST(test_batch_create_invalid_count) {
+  ck_assert_ptr_null(batch_create(0));
+  ck_assert_ptr_null(batch_create(-5));
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// Создание тестового набора для пакетного движка
+Suite *batch_suite_create(void) {
+  Suite *s = suite_create("Batch");
+
+  TCase *tc_kernels = tcase_create("Kernels");
+  tcase_add_test(tc_kernels, test_batch_collisions_match_scalar_engine);
+  tcase_add_test(tc_kernels, test_batch_full_rows_all_kernels);
+  suite_add_tcase(s, tc_kernels);
+
+  TCase *tc_lockstep = tcase_create("Lockstep");
+  tcase_add_test(tc_lockstep, test_batch_lockstep_scalar);
+  tcase_add_test(tc_lockstep, test_batch_lockstep_sse2);
+  tcase_add_test(tc_lockstep, test_batch_lockstep_avx2);
+  tcase_add_test(tc_lockstep, test_batch_create_invalid_count);
+  suite_add_tcase(s, tc_lockstep);
+
+  return s;
+}
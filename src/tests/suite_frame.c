@@ -0,0 +1,282 @@
+#include "gui/cli/frame.h"
+#include "gui/cli/renderer.h"
+#include "tests/suites.h"
+
+//----------------------------------------------------------------------------
+// --- Тесты сборки кадра ---
+
+START_TEST(test_compose_frame_includes_piece) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 1);
+  apply_user_action(&game, ActionStart);
+  update_game_state(&game);
+  while (game.current_piece.y < 0) move_piece(&game, 0, 1);
+
+  Frame_t frame;
+  compose_frame(&game, NULL, &frame);
+  int piece_cells = 0;
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    for (int x = 0; x < BOARD_WIDTH; x++) {
+      if (frame.cells[y][x]) {
+        ck_assert_int_eq(frame.cells[y][x], game.current_piece.color_index);
+        piece_cells++;
+      }
+    }
+  }
+  ck_assert_int_eq(piece_cells, 4);
+  ck_assert_int_eq(frame.next_piece, game.next_piece_index);
+  ck_assert_int_eq(frame.queue[0], -1);
+  ck_assert_int_eq(frame.overlay, OverlayNone);
+
+  set_preview_length(&game, 3);
+  compose_frame(&game, NULL, &frame);
+  ck_assert_int_eq(frame.queue[0], preview_piece(&game, 1));
+  ck_assert_int_eq(frame.queue[1], preview_piece(&game, 2));
+  ck_assert_int_ge(frame.queue[1], 0);
+}
+END_TEST
+
+START_TEST(test_compose_frame_overlay) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 1);
+  apply_user_action(&game, ActionStart);
+  update_game_state(&game);
+  apply_user_action(&game, ActionPause);
+
+  Frame_t frame;
+  compose_frame(&game, NULL, &frame);
+  ck_assert_int_eq(frame.overlay, OverlayPause);
+  ck_assert_str_eq(overlay_message(frame.overlay), "PAUSE");
+
+  apply_user_action(&game, ActionTerminate);
+  game.info.pause = false;
+  compose_frame(&game, NULL, &frame);
+  ck_assert_int_eq(frame.overlay, OverlayGameOver);
+  ck_assert_str_eq(overlay_message(frame.overlay), "GAME OVER");
+  ck_assert_ptr_null(overlay_message(OverlayNone));
+}
+END_TEST
+
+START_TEST(test_compose_frame_draws_ghost) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 7);
+  apply_user_action(&game, ActionStart);
+  update_game_state(&game);
+  while (game.current_piece.y < 0) move_piece(&game, 0, 1);
+
+  GhostCache_t ghost;
+  reset_ghost(&ghost);
+  Frame_t frame;
+  compose_frame(&game, &ghost, &frame);
+  int landing_y = game.current_piece.y + drop_distance(&game);
+  ck_assert_int_eq(ghost_landing_y(&ghost, &game), landing_y);
+  int ghost_cells = 0, piece_cells = 0;
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    for (int x = 0; x < BOARD_WIDTH; x++) {
+      if (frame.cells[y][x] == FRAME_GHOST) {
+        ck_assert_int_ge(y, landing_y);
+        ghost_cells++;
+      } else if (frame.cells[y][x]) {
+        piece_cells++;
+      }
+    }
+  }
+  ck_assert_int_eq(ghost_cells, 4);
+  ck_assert_int_eq(piece_cells, 4);
+}
+END_TEST
+
+START_TEST(test_ghost_cache_survives_gravity) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 8);
+  apply_user_action(&game, ActionStart);
+  update_game_state(&game);
+  while (game.current_piece.y < 0) move_piece(&game, 0, 1);
+
+  GhostCache_t ghost;
+  reset_ghost(&ghost);
+  int landing_y = ghost_landing_y(&ghost, &game);
+  move_piece(&game, 0, 1);
+  move_piece(&game, 0, 1);
+  ck_assert_int_eq(ghost_landing_y(&ghost, &game), landing_y);
+  ck_assert_int_eq(ghost.recomputes, 1);
+
+  move_piece(&game, 1, 0);
+  ghost_landing_y(&ghost, &game);
+  ck_assert_int_eq(ghost.recomputes, 2);
+  rotate_piece(&game);
+  ghost_landing_y(&ghost, &game);
+  ck_assert_int_eq(ghost.recomputes, 3);
+
+  for (int x = 0; x < BOARD_WIDTH; x++) {
+    set_board_cell(&game, x, BOARD_HEIGHT - 1, 1);
+  }
+  ck_assert_int_eq(ghost_landing_y(&ghost, &game),
+                   game.current_piece.y + drop_distance(&game));
+  ck_assert_int_eq(ghost.recomputes, 4);
+}
+END_TEST
+
+START_TEST(test_ghost_cache_under_overhang) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 9);
+  apply_user_action(&game, ActionStart);
+  update_game_state(&game);
+  for (int x = 0; x < BOARD_WIDTH; x++) set_board_cell(&game, x, 4, 1);
+  game.current_piece.y = 8;
+
+  GhostCache_t ghost;
+  reset_ghost(&ghost);
+  ck_assert_int_eq(ghost_landing_y(&ghost, &game),
+                   game.current_piece.y + drop_distance(&game));
+  ck_assert(!ghost.exact);
+  move_piece(&game, 0, 1);
+  ck_assert_int_eq(ghost_landing_y(&ghost, &game),
+                   game.current_piece.y + drop_distance(&game));
+  ck_assert_int_eq(ghost.recomputes, 2);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// --- Тесты сравнения кадров ---
+
+START_TEST(test_frame_dirty_rows_piece_move) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 2);
+  apply_user_action(&game, ActionStart);
+  update_game_state(&game);
+  for (int i = 0; i < 5; i++) move_piece(&game, 0, 1);
+
+  Frame_t before, after;
+  compose_frame(&game, NULL, &before);
+  ck_assert_uint_eq(frame_dirty_rows(&before, &before), 0);
+
+  apply_user_action(&game, ActionMoveLeft);
+  compose_frame(&game, NULL, &after);
+  uint32_t dirty = frame_dirty_rows(&before, &after);
+  ck_assert_uint_ne(dirty, 0);
+  // Изменились только строки под фигурой
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    bool under_piece =
+        y >= game.current_piece.y && y < game.current_piece.y + 4;
+    if (!under_piece) ck_assert(!(dirty >> y & 1));
+  }
+}
+END_TEST
+
+START_TEST(test_frame_dirty_rows_line_clear) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 3);
+  for (int x = 0; x < BOARD_WIDTH; x++) {
+    set_board_cell(&game, x, BOARD_HEIGHT - 1, 1);
+    if (x > 0) set_board_cell(&game, x, BOARD_HEIGHT - 2, 2);
+  }
+
+  Frame_t before, after;
+  compose_frame(&game, NULL, &before);
+  process_scoring_and_levelup(&game);
+  compose_frame(&game, NULL, &after);
+  ck_assert_uint_eq(frame_dirty_rows(&before, &after),
+                    3u << (BOARD_HEIGHT - 2));
+}
+END_TEST
+
+START_TEST(test_invalidate_frame_marks_everything) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 4);
+
+  Frame_t shown, frame;
+  invalidate_frame(&shown);
+  compose_frame(&game, NULL, &frame);
+  ck_assert_uint_eq(frame_dirty_rows(&shown, &frame),
+                    (1u << BOARD_HEIGHT) - 1);
+  ck_assert_int_ne(shown.score, frame.score);
+  ck_assert_int_ne(shown.next_piece, frame.next_piece);
+  ck_assert_int_ne(shown.overlay, frame.overlay);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// --- Тесты выводов без терминала ---
+
+START_TEST(test_null_renderer_counts_frames) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 5);
+  Renderer_t renderer;
+  null_renderer(&renderer);
+  ck_assert(renderer.init(&renderer));
+  renderer.draw(&renderer, &game);
+  renderer.draw(&renderer, &game);
+  ck_assert_int_eq(renderer.read_key(&renderer), -1);
+  renderer.cleanup(&renderer);
+  ck_assert_int_eq(renderer.frames, 2);
+  ck_assert_uint_eq(renderer.bytes, 0);
+  ck_assert_str_eq(renderer.name, "null");
+}
+END_TEST
+
+START_TEST(test_offscreen_renderer_rasterizes_frame) {
+  static Offscreen_t screen;
+  GameData_t game;
+  initialize_game_core(&game, 0, 6);
+  game.info.score = 1234;
+  set_board_cell(&game, 0, BOARD_HEIGHT - 1, 7);
+
+  Renderer_t renderer;
+  offscreen_renderer(&renderer, &screen);
+  ck_assert(renderer.init(&renderer));
+  renderer.draw(&renderer, &game);
+
+  int bottom = BOARD_WINDOW_Y + BOARD_HEIGHT;
+  ck_assert_int_eq(screen.color[bottom][BOARD_WINDOW_X + 1], 7);
+  ck_assert_int_eq(screen.color[bottom][BOARD_WINDOW_X + 2], 7);
+  ck_assert_int_eq(screen.color[bottom][BOARD_WINDOW_X + 3], 0);
+  ck_assert_mem_eq(&screen.text[INFO_WINDOW_Y + 2][INFO_WINDOW_X + 2],
+                   "Score: 1234", 11);
+  // Без предпросмотра очередь под следующей фигурой пуста
+  ck_assert_int_eq(screen.color[INFO_WINDOW_Y + QUEUE_ROW + 1]
+                               [INFO_WINDOW_X + PREVIEW_COL + 2],
+                   0);
+
+  set_preview_length(&game, 2);
+  renderer.draw(&renderer, &game);
+  int queued = preview_piece(&game, 1);
+  for (int j = 0; j < 4; j++) {
+    ck_assert_int_eq(screen.color[INFO_WINDOW_Y + QUEUE_ROW + 1]
+                                 [INFO_WINDOW_X + PREVIEW_COL + j * 2],
+                     FIGURES[queued][2][j] ? queued + 1 : 0);
+  }
+
+  apply_user_action(&game, ActionTerminate);
+  renderer.draw(&renderer, &game);
+  int x = BOARD_WINDOW_X + (BOARD_WINDOW_WIDTH - 9) / 2;
+  ck_assert_mem_eq(&screen.text[BOARD_WINDOW_Y + OVERLAY_ROW + 1][x],
+                   "GAME OVER", 9);
+  ck_assert_int_eq(renderer.frames, 3);
+  renderer.cleanup(&renderer);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// Создание тестового набора для кадров отрисовки
+Suite *frame_suite_create(void) {
+  Suite *s = suite_create("Frame");
+
+  TCase *tc_frame = tcase_create("Frame");
+  tcase_add_test(tc_frame, test_compose_frame_includes_piece);
+  tcase_add_test(tc_frame, test_compose_frame_overlay);
+  tcase_add_test(tc_frame, test_compose_frame_draws_ghost);
+  tcase_add_test(tc_frame, test_ghost_cache_survives_gravity);
+  tcase_add_test(tc_frame, test_ghost_cache_under_overhang);
+  tcase_add_test(tc_frame, test_frame_dirty_rows_piece_move);
+  tcase_add_test(tc_frame, test_frame_dirty_rows_line_clear);
+  tcase_add_test(tc_frame, test_invalidate_frame_marks_everything);
+  suite_add_tcase(s, tc_frame);
+
+  TCase *tc_renderer = tcase_create("Renderer");
+  tcase_add_test(tc_renderer, test_null_renderer_counts_frames);
+  tcase_add_test(tc_renderer, test_offscreen_renderer_rasterizes_frame);
+  suite_add_tcase(s, tc_renderer);
+
+  return s;
+}
@@ -0,0 +1,174 @@
+#include "brickgame/tetris/perft.h"
+#include "tests/suites.h"
+
+#define PATH_CAPACITY 128
+
+// --- Утилита для тестов: детерминированный генератор для полей ---
+static unsigned next_random(unsigned *state) {
+  *state = *state * 1103515245u + 12345u;
+  return (*state >> 16) & 0x7FFF;
+}
+
+// --- Утилита для тестов: проходит путь так же, как это сделал бы игрок ---
+static void replay_path(GameData_t *game, const UserAction_t *path,
+                        int length) {
+  for (int i = 0; i < length; i++) {
+    if (path[i] == ActionNone) {
+      int before = game->current_piece.y;
+      move_piece(game, 0, 1);
+      ck_assert_int_eq(game->current_piece.y, before + 1);
+    } else {
+      apply_user_action(game, path[i]);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// --- Тесты генератора ходов ---
+
+START_TEST(test_movegen_empty_board_counts) {
+  // I, O, T, L, J, S, Z на пустом поле 10x20
+  static const int expected[PIECE_COUNT] = {17, 9, 34, 34, 34, 17, 17};
+  static MoveGen_t gen;
+  GameData_t game;
+  initialize_game_core(&game, 0, 1);
+
+  for (int piece = 0; piece < PIECE_COUNT; piece++) {
+    ck_assert_int_eq(generate_spawn_placements(&gen, &game, piece),
+                     expected[piece]);
+  }
+}
+END_TEST
+
+START_TEST(test_movegen_paths_reach_placements) {
+  static MoveGen_t gen;
+  unsigned seed = 5;
+  for (int round = 0; round < 20; round++) {
+    GameData_t game;
+    initialize_game_core(&game, 0, 1);
+    for (int y = 10; y < BOARD_HEIGHT; y++) {
+      for (int x = 0; x < BOARD_WIDTH; x++) {
+        if (next_random(&seed) % 2) set_board_cell(&game, x, y, 1);
+      }
+    }
+
+    int piece = round % PIECE_COUNT;
+    int count = generate_spawn_placements(&gen, &game, piece);
+    ck_assert_int_gt(count, 0);
+    for (int i = 0; i < count; i++) {
+      UserAction_t path[PATH_CAPACITY];
+      int length = placement_path(&gen, i, path, PATH_CAPACITY);
+      ck_assert_int_le(length, PATH_CAPACITY);
+      ck_assert_int_eq(path[length - 1], ActionMoveDown);
+
+      GameData_t copy = game;
+      copy.state = Moving;
+      copy.current_piece = (CurrentPiece_t){piece, 0, SPAWN_X, SPAWN_Y, 1};
+      replay_path(&copy, path, length);
+
+      CurrentPiece_t target = placement_piece(&gen, i);
+      ck_assert_int_eq(copy.state, Attaching);
+      ck_assert_int_eq(copy.current_piece.rotation, target.rotation);
+      ck_assert_int_eq(copy.current_piece.x, target.x);
+      ck_assert_int_eq(copy.current_piece.y, target.y);
+    }
+  }
+}
+END_TEST
+
+START_TEST(test_movegen_finds_tuck_under_overhang) {
+  static MoveGen_t gen;
+  GameData_t game;
+  initialize_game_core(&game, 0, 1);
+  // "Крыша" над правой частью поля, слева свободный колодец шириной 2
+  for (int x = 2; x < BOARD_WIDTH; x++) set_board_cell(&game, x, 16, 1);
+
+  int count = generate_spawn_placements(&gen, &game, 1);
+  bool tucked = false;
+  for (int i = 0; i < count; i++) {
+    GameData_t copy = game;
+    copy.current_piece = placement_piece(&gen, i);
+    imprint_piece_to_board(&copy);
+    if (copy.board[19][9]) tucked = true;
+  }
+  ck_assert(tucked);
+}
+END_TEST
+
+START_TEST(test_movegen_blocked_spawn) {
+  static MoveGen_t gen;
+  GameData_t game;
+  initialize_game_core(&game, 0, 1);
+  for (int x = 0; x < BOARD_WIDTH; x++) set_board_cell(&game, x, 0, 1);
+
+  ck_assert_int_eq(generate_spawn_placements(&gen, &game, 0), 0);
+}
+END_TEST
+
+START_TEST(test_movegen_canonical_rotations) {
+  init_piece_tables();
+  // У O все повороты одинаковы, у T все различны
+  for (int r = 0; r < ROTATION_COUNT; r++) {
+    ck_assert_int_eq(PIECE_ROTATIONS[1][r].canonical, 0);
+    ck_assert_int_eq(PIECE_ROTATIONS[2][r].canonical, r);
+  }
+  ck_assert_int_eq(PIECE_ROTATIONS[0][2].canonical, 0);
+  ck_assert_int_eq(PIECE_ROTATIONS[0][3].canonical, 1);
+}
+END_TEST
+
+START_TEST(test_perft_queue_matches_game) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 99);
+  int queue[8];
+  perft_queue(&game, queue, 8);
+
+  for (int i = 0; i < 8; i++) {
+    ck_assert_int_eq(queue[i], game.next_piece_index);
+    game.next_piece_index = generate_new_shape(&game);
+  }
+
+  // Фигуры из очереди предпросмотра идут в начале, дальше — генератор
+  int with_preview[8];
+  initialize_game_core(&game, 0, 99);
+  set_preview_length(&game, 4);
+  perft_queue(&game, with_preview, 8);
+  ck_assert_mem_eq(with_preview, queue, sizeof(queue));
+}
+END_TEST
+
+START_TEST(test_perft_reference_counts) {
+  // Эталонные значения для seed = 1 (очередь T T I)
+  static const uint64_t expected[] = {1, 34, 1178, 20868};
+  static MoveGen_t gens[3];
+  GameData_t game;
+  initialize_game_core(&game, 0, 1);
+  int queue[3];
+  perft_queue(&game, queue, 3);
+
+  for (int depth = 0; depth <= 3; depth++) {
+    ck_assert_uint_eq(perft(gens, &game, queue, depth), expected[depth]);
+  }
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// Создание тестового набора для генератора ходов
+Suite *movegen_suite_create(void) {
+  Suite *s = suite_create("MoveGen");
+
+  TCase *tc_movegen = tcase_create("Placements");
+  tcase_add_test(tc_movegen, test_movegen_empty_board_counts);
+  tcase_add_test(tc_movegen, test_movegen_paths_reach_placements);
+  tcase_add_test(tc_movegen, test_movegen_finds_tuck_under_overhang);
+  tcase_add_test(tc_movegen, test_movegen_blocked_spawn);
+  tcase_add_test(tc_movegen, test_movegen_canonical_rotations);
+  suite_add_tcase(s, tc_movegen);
+
+  TCase *tc_perft = tcase_create("Perft");
+  tcase_add_test(tc_perft, test_perft_queue_matches_game);
+  tcase_add_test(tc_perft, test_perft_reference_counts);
+  suite_add_tcase(s, tc_perft);
+
+  return s;
+}
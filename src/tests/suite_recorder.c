@@ -0,0 +1,205 @@
+#include <stdio.h>
+
+#include "brickgame/tetris/recorder.h"
+#include "tests/suites.h"
+
+#define REPLAY_TEST_FILE "test_replay.bin"
+
+// --- Утилита для тестов: детерминированный генератор для действий ---
+static unsigned next_random(unsigned *state) {
+  *state = *state * 1103515245u + 12345u;
+  return (*state >> 16) & 0x7FFF;
+}
+
+//----------------------------------------------------------------------------
+// --- Тесты записи и воспроизведения ---
+
+START_TEST(test_replay_reproduces_game) {
+  static const UserAction_t ACTIONS[] = {
+      ActionNone,      ActionNone,   ActionNone,     ActionNone,
+      ActionMoveLeft,  ActionRotate, ActionMoveDown, ActionNone,
+      ActionMoveRight, ActionPause,  ActionPause};
+  unsigned seed = 3;
+  GameData_t game;
+  initialize_game_core(&game, 250, 77);
+
+  Recorder_t recorder;
+  ReplayHeader_t header = {REPLAY_VERSION, 0, 77, 250, 0, 0};
+  ck_assert(recorder_open(&recorder, REPLAY_TEST_FILE, &header));
+  long tick = 0;
+  for (; tick < 20000 && game.state != GameOver; tick++) {
+    UserAction_t action =
+        tick == 0 ? ActionStart : ACTIONS[next_random(&seed) % 11];
+    ck_assert(recorder_record(&recorder, tick, action));
+    apply_user_action(&game, action);
+    update_game_state(&game);
+  }
+  ck_assert(recorder_close(&recorder, tick));
+
+  GameData_t replayed;
+  ck_assert_int_eq(replay_run(REPLAY_TEST_FILE, &replayed), tick);
+  ck_assert_int_eq(replayed.state, game.state);
+  ck_assert_int_eq(replayed.info.score, game.info.score);
+  ck_assert_int_eq(replayed.info.high_score, game.info.high_score);
+  ck_assert_int_eq(memcmp(replayed.board, game.board, sizeof(game.board)),
+                   0);
+  ck_assert_uint_eq(replayed.generator.rng.state, game.generator.rng.state);
+  remove(REPLAY_TEST_FILE);
+}
+END_TEST
+
+START_TEST(test_replay_header_and_events) {
+  Recorder_t recorder;
+  ReplayHeader_t header = {REPLAY_VERSION, REPLAY_FLAG_BAG7,
+                           0x0123456789ABCDEFULL, 123456, 0, 0};
+  ck_assert(recorder_open(&recorder, REPLAY_TEST_FILE, &header));
+  ck_assert(recorder_record(&recorder, 0, ActionStart));
+  ck_assert(recorder_record(&recorder, 5, ActionNone));  // не записывается
+  ck_assert(recorder_record(&recorder, 7, ActionRotate));
+  ck_assert(recorder_record(&recorder, 7, ActionMoveLeft));
+  ck_assert(recorder_record(&recorder, 1000000, ActionTerminate));
+  ck_assert(recorder_close(&recorder, 1000001));
+
+  ReplayReader_t reader;
+  ck_assert(replay_open(&reader, REPLAY_TEST_FILE));
+  ck_assert_int_eq(reader.header.version, REPLAY_VERSION);
+  ck_assert_int_eq(reader.header.flags, REPLAY_FLAG_BAG7);
+  ck_assert_uint_eq(reader.header.seed, 0x0123456789ABCDEFULL);
+  ck_assert_int_eq(reader.header.high_score, 123456);
+
+  static const long ticks[] = {0, 7, 7, 1000000};
+  static const UserAction_t actions[] = {ActionStart, ActionRotate,
+                                         ActionMoveLeft, ActionTerminate};
+  long tick;
+  UserAction_t action;
+  for (int i = 0; i < 4; i++) {
+    ck_assert(replay_next(&reader, &tick, &action));
+    ck_assert_int_eq(tick, ticks[i]);
+    ck_assert_int_eq(action, actions[i]);
+  }
+  ck_assert(!replay_next(&reader, &tick, &action));
+  ck_assert_int_eq(reader.tick, 1000001);
+  replay_close(&reader);
+  remove(REPLAY_TEST_FILE);
+}
+END_TEST
+
+START_TEST(test_replay_rejects_bad_file) {
+  FILE *file = fopen(REPLAY_TEST_FILE, "wb");
+  ck_assert_ptr_nonnull(file);
+  fputs("not a replay file", file);
+  fclose(file);
+
+  ReplayReader_t reader;
+  GameData_t game;
+  ck_assert(!replay_open(&reader, REPLAY_TEST_FILE));
+  ck_assert_int_eq(replay_run(REPLAY_TEST_FILE, &game), -1);
+  ck_assert_int_eq(replay_run("missing_replay.bin", &game), -1);
+  remove(REPLAY_TEST_FILE);
+}
+END_TEST
+
+START_TEST(test_replay_truncated_file) {
+  Recorder_t recorder;
+  ReplayHeader_t header = {REPLAY_VERSION, 0, 5, 0, 0, 0};
+  ck_assert(recorder_open(&recorder, REPLAY_TEST_FILE, &header));
+  ck_assert(recorder_record(&recorder, 0, ActionStart));
+  ck_assert(recorder_record(&recorder, 30, ActionMoveDown));
+  // Имитация аварийного завершения: метка конца не записана
+  fclose(recorder.file);
+
+  GameData_t game;
+  ck_assert_int_eq(replay_run(REPLAY_TEST_FILE, &game), 31);
+  remove(REPLAY_TEST_FILE);
+}
+END_TEST
+
+START_TEST(test_replay_settle_flag) {
+  Recorder_t recorder;
+  ReplayHeader_t header = {REPLAY_VERSION, REPLAY_FLAG_SETTLE, 9, 0, 0, 0};
+  ck_assert(recorder_open(&recorder, REPLAY_TEST_FILE, &header));
+  ck_assert(recorder_record(&recorder, 0, ActionStart));
+  ck_assert(recorder_record(&recorder, 3, ActionMoveDown));
+  ck_assert(recorder_close(&recorder, 4));
+
+  GameData_t game;
+  ck_assert_int_eq(replay_run(REPLAY_TEST_FILE, &game), 4);
+  ck_assert(game.settle_transitions);
+  ck_assert_int_eq(game.state, Moving);
+  ck_assert_int_eq(game.piece_count, 2);
+  remove(REPLAY_TEST_FILE);
+}
+END_TEST
+
+START_TEST(test_replay_auto_shift_events) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 31);
+  set_settle_transitions(&game, true);
+  set_auto_shift(&game, 40, 5);
+
+  Recorder_t recorder;
+  ReplayHeader_t header = {
+      REPLAY_VERSION, REPLAY_FLAG_SETTLE | REPLAY_FLAG_AUTO_SHIFT, 31, 0, 40,
+      5};
+  ck_assert(recorder_open(&recorder, REPLAY_TEST_FILE, &header));
+  unsigned seed = 17;
+  long tick = 0;
+  for (; tick < 3000 && game.state != GameOver; tick++) {
+    unsigned roll = next_random(&seed) % 16;
+    int direction = roll & 1 ? 1 : -1;
+    long time = game_subtick(&game, (int)(next_random(&seed) % 16) - 8);
+    if (tick == 0) {
+      ck_assert(recorder_record(&recorder, tick, ActionStart));
+      apply_user_action(&game, ActionStart);
+    } else if (roll < 4) {
+      ck_assert(
+          recorder_record_shift(&recorder, tick, direction, time, roll < 2));
+      if (roll < 2)
+        release_shift(&game, direction, time);
+      else
+        press_shift(&game, direction, time);
+    } else if (roll == 4) {
+      ck_assert(recorder_record(&recorder, tick, ActionRotate));
+      apply_user_action(&game, ActionRotate);
+    } else if (roll == 5 && tick % 7 == 0) {
+      ck_assert(recorder_record(&recorder, tick, ActionMoveDown));
+      apply_user_action(&game, ActionMoveDown);
+    }
+    update_game_state(&game);
+  }
+  ck_assert(recorder_close(&recorder, tick));
+
+  ReplayReader_t reader;
+  ck_assert(replay_open(&reader, REPLAY_TEST_FILE));
+  ck_assert_int_eq(reader.header.das, 40);
+  ck_assert_int_eq(reader.header.arr, 5);
+  replay_close(&reader);
+
+  GameData_t replayed;
+  ck_assert_int_eq(replay_run(REPLAY_TEST_FILE, &replayed), tick);
+  ck_assert_int_eq(replayed.auto_shift.das, 40);
+  ck_assert_int_eq(replayed.state, game.state);
+  ck_assert_int_eq(replayed.piece_count, game.piece_count);
+  ck_assert_int_eq(replayed.current_piece.x, game.current_piece.x);
+  ck_assert_int_eq(memcmp(replayed.board, game.board, sizeof(game.board)),
+                   0);
+  remove(REPLAY_TEST_FILE);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// Создание тестового набора для записи игр
+Suite *recorder_suite_create(void) {
+  Suite *s = suite_create("Recorder");
+
+  TCase *tc_replay = tcase_create("Replay");
+  tcase_add_test(tc_replay, test_replay_reproduces_game);
+  tcase_add_test(tc_replay, test_replay_header_and_events);
+  tcase_add_test(tc_replay, test_replay_rejects_bad_file);
+  tcase_add_test(tc_replay, test_replay_truncated_file);
+  tcase_add_test(tc_replay, test_replay_settle_flag);
+  tcase_add_test(tc_replay, test_replay_auto_shift_events);
+  suite_add_tcase(s, tc_replay);
+
+  return s;
+}
@@ -1,13 +1,15 @@
-#include <check.h>
 #include <stdio.h>  // Для работы с файлами в тестах
 
 #include "brickgame/tetris/tetris.h"  // Подключаем нашу логику
+#include "tests/suites.h"
 
 // --- Тесты для функции generate_new_shape ---
 
 START_TEST(test_generate_new_shape_range) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 42);
   for (int i = 0; i < 1000; i++) {
-    int shape_index = generate_new_shape();
+    int shape_index = generate_new_shape(&game);
 
     ck_assert_int_ge(shape_index, 0);
     ck_assert_int_le(shape_index, 6);
@@ -15,15 +17,117 @@ START_TEST(test_generate_new_shape_range) {
 }
 END_TEST
 
+START_TEST(test_generate_same_seed_same_sequence) {
+  GameData_t first, second;
+  initialize_game_core(&first, 0, 2024);
+  initialize_game_core(&second, 0, 2024);
+  ck_assert_int_eq(first.next_piece_index, second.next_piece_index);
+  for (int i = 0; i < 500; i++) {
+    ck_assert_int_eq(generate_new_shape(&first), generate_new_shape(&second));
+  }
+}
+END_TEST
+
+START_TEST(test_generate_different_seeds_differ) {
+  GameData_t first, second;
+  initialize_game_core(&first, 0, 1);
+  initialize_game_core(&second, 0, 2);
+  int differences = 0;
+  for (int i = 0; i < 100; i++) {
+    differences += generate_new_shape(&first) != generate_new_shape(&second);
+  }
+  ck_assert_int_gt(differences, 0);
+}
+END_TEST
+
+START_TEST(test_generate_bag7_contains_every_piece) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 5);
+  set_randomizer(&game, RandomizerBag7);
+  // next_piece_index уже взят из первого мешка: добираем его остаток
+  int seen[PIECE_COUNT] = {0};
+  seen[game.next_piece_index]++;
+  for (int i = 1; i < PIECE_COUNT; i++) seen[generate_new_shape(&game)]++;
+  for (int piece = 0; piece < PIECE_COUNT; piece++) {
+    ck_assert_int_eq(seen[piece], 1);
+  }
+
+  // Каждый следующий мешок также содержит все семь фигур
+  for (int bag = 0; bag < 20; bag++) {
+    memset(seen, 0, sizeof(seen));
+    for (int i = 0; i < PIECE_COUNT; i++) seen[generate_new_shape(&game)]++;
+    for (int piece = 0; piece < PIECE_COUNT; piece++) {
+      ck_assert_int_eq(seen[piece], 1);
+    }
+  }
+}
+END_TEST
+
+START_TEST(test_preview_keeps_piece_sequence) {
+  for (int mode = RandomizerUniform; mode <= RandomizerBag7; mode++) {
+    GameData_t plain, ahead;
+    initialize_game_core(&plain, 0, 77);
+    initialize_game_core(&ahead, 0, 77);
+    set_randomizer(&plain, (Randomizer_t)mode);
+    set_randomizer(&ahead, (Randomizer_t)mode);
+    set_preview_length(&ahead, 6);
+    ck_assert_int_eq(ahead.preview.length, 6);
+
+    for (int i = 0; i < 100; i++) {
+      // Очередь всегда показывает пять фигур после следующей
+      ck_assert_int_ge(ahead.preview.count, 5);
+      ck_assert_int_eq(preview_piece(&ahead, 0), plain.next_piece_index);
+      ck_assert_int_eq(preview_piece(&plain, 1), -1);
+      spawn_new_piece(&plain);
+      spawn_new_piece(&ahead);
+      ck_assert_int_eq(ahead.current_piece.piece, plain.current_piece.piece);
+      ck_assert_int_eq(ahead.next_piece_index, plain.next_piece_index);
+    }
+
+    // Фигуры предпросмотра — это фигуры, которые появятся следом
+    int expected[5];
+    for (int i = 0; i < 5; i++) expected[i] = preview_piece(&ahead, i + 1);
+    for (int i = 0; i < 5; i++) {
+      spawn_new_piece(&ahead);
+      ck_assert_int_eq(ahead.next_piece_index, expected[i]);
+    }
+  }
+}
+END_TEST
+
+START_TEST(test_preview_length_is_clamped) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 3);
+  set_preview_length(&game, 100);
+  ck_assert_int_eq(game.preview.length, PREVIEW_MAX);
+  ck_assert_int_ne(preview_piece(&game, PREVIEW_MAX - 1), -1);
+  set_preview_length(&game, 0);
+  ck_assert_int_eq(game.preview.length, 1);
+  // Уже взятые из генератора фигуры не пропадают
+  ck_assert_int_ne(preview_piece(&game, 1), -1);
+  ck_assert_int_eq(preview_piece(&game, -1), -1);
+}
+END_TEST
+
 //----------------------------------------------------------------------------
 // утилиты для тестов
 
 static void setup_game_with_piece(GameData_t *game, int piece_index) {
   initialize_game(game);
-  memcpy(game->current_piece.shape, FIGURES[piece_index], sizeof(int) * 16);
+  game->current_piece.piece = piece_index;
+  game->current_piece.rotation = 0;
   game->current_piece.color_index = piece_index + 1;
 }
 
+// --- Утилита для тестов: разворачивает текущий поворот фигуры в матрицу ---
+static void get_piece_shape(const CurrentPiece_t *piece, int shape[4][4]) {
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      shape[i][j] = piece_cell(piece, i, j);
+    }
+  }
+}
+
 // --- Утилита для тестов: создает структуру GameInfo_t ---
 static GameInfo_t create_game_info(int score, int level) {
   GameInfo_t info = {0};  // Инициализируем нулями
@@ -100,7 +204,7 @@ START_TEST(test_collision_with_another_piece) {
   setup_game_with_piece(&game, piece_index);
 
   // Помещаем "стену" на поле
-  game.board[10][5] = 1;
+  set_board_cell(&game, 5, 10, 1);
 
   // Двигаем нашу фигуру прямо на эту "стену"
   game.current_piece.x = 2;
@@ -174,8 +278,8 @@ START_TEST(test_clear_no_lines) {
   GameData_t game;
   initialize_game(&game);
   // Частично заполняем поле, но без полных линий
-  game.board[19][5] = 1;
-  game.board[18][2] = 2;
+  set_board_cell(&game, 5, 19, 1);
+  set_board_cell(&game, 2, 18, 2);
 
   int cleared = clear_lines(&game);
 
@@ -191,10 +295,10 @@ START_TEST(test_clear_one_bottom_line) {
   initialize_game(&game);
   // Заполняем нижнюю линию
   for (int x = 0; x < BOARD_WIDTH; x++) {
-    game.board[19][x] = 1;
+    set_board_cell(&game, x, 19, 1);
   }
   // Добавляем блок сверху, который должен сдвинуться вниз
-  game.board[18][5] = 2;
+  set_board_cell(&game, 5, 18, 2);
 
   int cleared = clear_lines(&game);
 
@@ -213,7 +317,7 @@ START_TEST(test_clear_four_lines_tetris) {
   // Заполняем 4 нижние линии
   for (int y = 16; y < 20; y++) {
     for (int x = 0; x < BOARD_WIDTH; x++) {
-      game.board[y][x] = y - 15;  // Разные цвета для наглядности
+      set_board_cell(&game, x, y, y - 15);  // Разные цвета для наглядности
     }
   }
 
@@ -238,13 +342,13 @@ START_TEST(test_clear_line_in_the_middle) {
   initialize_game(&game);
 
   // Блок ниже очищаемой линии (должен остаться на месте)
-  game.board[15][5] = 1;
+  set_board_cell(&game, 5, 15, 1);
   // Линия для очистки
   for (int x = 0; x < BOARD_WIDTH; x++) {
-    game.board[14][x] = 2;
+    set_board_cell(&game, x, 14, 2);
   }
   // Блок выше очищаемой линии (должен сдвинуться)
-  game.board[13][5] = 3;
+  set_board_cell(&game, 5, 13, 3);
 
   int cleared = clear_lines(&game);
 
@@ -258,6 +362,39 @@ START_TEST(test_clear_line_in_the_middle) {
 }
 END_TEST
 
+START_TEST(test_clear_split_lines) {
+  GameData_t game;
+  initialize_game(&game);
+  // Две полные линии с неполной между ними
+  for (int x = 0; x < BOARD_WIDTH; x++) {
+    set_board_cell(&game, x, 19, 1);
+    set_board_cell(&game, x, 17, 2);
+  }
+  set_board_cell(&game, 3, 18, 3);
+  set_board_cell(&game, 7, 16, 4);
+  ck_assert_uint_eq(game.full_rows, (1u << 19) | (1u << 17));
+
+  // Снятый блок убирает линию из маски полных строк
+  set_board_cell(&game, 0, 17, 0);
+  ck_assert_uint_eq(game.full_rows, 1u << 19);
+  set_board_cell(&game, 0, 17, 2);
+
+  int cleared = clear_lines(&game);
+
+  ck_assert_int_eq(cleared, 2);
+  ck_assert_uint_eq(game.full_rows, 0);
+  // Уцелевшие строки сдвинулись на число очищенных под ними линий
+  ck_assert_int_eq(game.board[19][3], 3);
+  ck_assert_int_eq(game.board[18][7], 4);
+  ck_assert_uint_eq(game.rows[19], 1u << 3);
+  ck_assert_uint_eq(game.rows[18], 1u << 7);
+  ck_assert_uint_eq(game.rows[17], 0);
+  ck_assert_int_eq(game.heights[3], 1);
+  ck_assert_int_eq(game.heights[7], 2);
+  ck_assert_int_eq(game.heights[0], 0);
+}
+END_TEST
+
 //----------------------------------------------------------------------------
 // --- Тесты для функции process_scoring_and_levelup ---
 
@@ -265,8 +402,8 @@ START_TEST(test_process_scoring_when_no_lines_cleared) {
   GameData_t game;
   initialize_game(&game);
   // Поле с "мусором", но без полных линий
-  game.board[19][0] = 1;
-  game.board[18][9] = 2;
+  set_board_cell(&game, 0, 19, 1);
+  set_board_cell(&game, 9, 18, 2);
 
   int initial_score = game.info.score;
   int initial_level = game.info.level;
@@ -285,7 +422,7 @@ START_TEST(test_process_scoring_when_one_line_cleared) {
   initialize_game(&game);
   // Заполняем одну линию
   for (int x = 0; x < BOARD_WIDTH; x++) {
-    game.board[19][x] = 1;
+    set_board_cell(&game, x, 19, 1);
   }
 
   process_scoring_and_levelup(&game);
@@ -307,7 +444,7 @@ START_TEST(test_process_scoring_with_tetris_and_levelup) {
   // Заполняем 4 линии для "Тетриса"
   for (int y = 16; y < 20; y++) {
     for (int x = 0; x < BOARD_WIDTH; x++) {
-      game.board[y][x] = 1;
+      set_board_cell(&game, x, y, 1);
     }
   }
 
@@ -460,6 +597,222 @@ START_TEST(test_get_action_special_cases) {
 }
 END_TEST
 
+// --- Утилита для тестов: игра с фигурой в состоянии Moving ---
+static void start_moving_game(GameData_t *game, uint64_t seed, int drop) {
+  initialize_game_core(game, 0, seed);
+  apply_user_action(game, ActionStart);
+  update_game_state(game);
+  for (int i = 0; i < drop; i++) move_piece(game, 0, 1);
+}
+
+// --- Утилита для тестов: применяет действия по одному и свернутыми ---
+static int apply_both(GameData_t *sequential, GameData_t *batched,
+                      const UserAction_t *actions, int count,
+                      UserAction_t *out, InputStats_t *stats) {
+  int length = coalesce_actions(batched, actions, count, out, stats);
+  for (int i = 0; i < count; i++) apply_user_action(sequential, actions[i]);
+  for (int i = 0; i < length; i++) apply_user_action(batched, out[i]);
+
+  ck_assert_int_eq(batched->state, sequential->state);
+  ck_assert_int_eq(batched->info.pause, sequential->info.pause);
+  ck_assert_int_eq(batched->current_piece.rotation,
+                   sequential->current_piece.rotation);
+  ck_assert_int_eq(batched->current_piece.x, sequential->current_piece.x);
+  ck_assert_int_eq(batched->current_piece.y, sequential->current_piece.y);
+  return length;
+}
+
+START_TEST(test_coalesce_net_horizontal_shift) {
+  const UserAction_t actions[] = {ActionMoveLeft, ActionMoveRight,
+                                  ActionMoveLeft, ActionMoveLeft,
+                                  ActionRotate,   ActionMoveRight,
+                                  ActionMoveLeft};
+  GameData_t sequential, batched;
+  start_moving_game(&sequential, 1, 6);
+  batched = sequential;
+  UserAction_t out[7];
+  InputStats_t stats = {0, 0, 0};
+  int length = apply_both(&sequential, &batched, actions, 7, out, &stats);
+
+  ck_assert_int_eq(length, 3);
+  ck_assert_int_eq(out[0], ActionMoveLeft);
+  ck_assert_int_eq(out[1], ActionMoveLeft);
+  ck_assert_int_eq(out[2], ActionRotate);
+  ck_assert_int_eq(stats.events, 7);
+  ck_assert_int_eq(stats.coalesced, 4);
+  ck_assert_int_eq(stats.dropped, 0);
+}
+END_TEST
+
+START_TEST(test_coalesce_rotations_and_pauses) {
+  const UserAction_t actions[] = {ActionRotate, ActionRotate, ActionRotate,
+                                  ActionRotate, ActionRotate, ActionPause,
+                                  ActionPause,  ActionStart,  ActionStart};
+  GameData_t sequential, batched;
+  start_moving_game(&sequential, 2, 6);
+  batched = sequential;
+  UserAction_t out[9];
+  InputStats_t stats = {0, 0, 0};
+  int length = apply_both(&sequential, &batched, actions, 9, out, &stats);
+
+  // Старт во время игры ничего не делает и отбрасывается
+  ck_assert_int_eq(length, 1);
+  ck_assert_int_eq(out[0], ActionRotate);
+  ck_assert_int_eq(stats.coalesced, 6);
+  ck_assert_int_eq(stats.dropped, 2);
+}
+END_TEST
+
+START_TEST(test_coalesce_drops_after_hard_drop) {
+  const UserAction_t actions[] = {ActionMoveDown, ActionMoveLeft,
+                                  ActionMoveDown, ActionPause,
+                                  ActionMoveRight, ActionTerminate,
+                                  ActionRotate};
+  GameData_t sequential, batched;
+  start_moving_game(&sequential, 3, 0);
+  batched = sequential;
+  UserAction_t out[7];
+  InputStats_t stats = {0, 0, 0};
+  int length = apply_both(&sequential, &batched, actions, 7, out, &stats);
+
+  ck_assert_int_eq(length, 3);
+  ck_assert_int_eq(out[0], ActionMoveDown);
+  ck_assert_int_eq(out[1], ActionPause);
+  ck_assert_int_eq(out[2], ActionTerminate);
+  ck_assert_int_eq(stats.dropped, 4);
+  ck_assert_int_eq(stats.coalesced, 0);
+}
+END_TEST
+
+START_TEST(test_coalesce_start_after_ignored_drop) {
+  // В заставке падение ничего не делает, но старт после него нужен
+  const UserAction_t actions[] = {ActionMoveDown, ActionStart, ActionStart};
+  GameData_t sequential, batched;
+  initialize_game_core(&sequential, 0, 4);
+  batched = sequential;
+  UserAction_t out[3];
+  int length = apply_both(&sequential, &batched, actions, 3, out, NULL);
+
+  ck_assert_int_eq(length, 1);
+  ck_assert_int_eq(out[0], ActionStart);
+  ck_assert_int_eq(batched.state, Spawn);
+}
+END_TEST
+
+START_TEST(test_coalesce_blocked_shift) {
+  const UserAction_t actions[] = {ActionMoveLeft, ActionMoveLeft,
+                                  ActionMoveLeft, ActionMoveRight};
+  GameData_t sequential, batched;
+  start_moving_game(&sequential, 5, 6);
+  for (int i = 0; i < BOARD_WIDTH; i++) move_piece(&sequential, -1, 0);
+  int wall_x = sequential.current_piece.x;
+  batched = sequential;
+  UserAction_t out[4];
+  InputStats_t stats = {0, 0, 0};
+  int length = apply_both(&sequential, &batched, actions, 4, out, &stats);
+
+  // Сдвиги в стену не выполняются: фигура на клетку правее стены, а не
+  // на две левее, как дал бы чистый сдвиг
+  ck_assert_int_eq(length, 1);
+  ck_assert_int_eq(out[0], ActionMoveRight);
+  ck_assert_int_eq(batched.current_piece.x, wall_x + 1);
+  ck_assert_int_eq(stats.dropped, 3);
+}
+END_TEST
+
+START_TEST(test_coalesce_blocked_rotation) {
+  GameData_t sequential, batched;
+  start_moving_game(&sequential, 6, 0);
+  sequential.current_piece = (CurrentPiece_t){0, 0, 3, 8, 1};
+  // Блок в клетке, которую занимает только третий поворот палки I
+  CurrentPiece_t turned[3];
+  for (int r = 0; r < 3; r++) {
+    turned[r] = sequential.current_piece;
+    turned[r].rotation = r;
+  }
+  bool blocked = false;
+  for (int row = 0; row < 4 && !blocked; row++) {
+    for (int col = 0; col < 4 && !blocked; col++) {
+      if (piece_cell(&turned[2], row, col) &&
+          !piece_cell(&turned[0], row, col) &&
+          !piece_cell(&turned[1], row, col)) {
+        set_board_cell(&sequential, 3 + col, 8 + row, 7);
+        blocked = true;
+      }
+    }
+  }
+  ck_assert(blocked);
+  batched = sequential;
+
+  const UserAction_t actions[] = {ActionRotate, ActionRotate, ActionRotate,
+                                  ActionRotate};
+  UserAction_t out[4];
+  InputStats_t stats = {0, 0, 0};
+  int length = apply_both(&sequential, &batched, actions, 4, out, &stats);
+
+  // Четыре поворота не сокращаются до нуля: второй упирается в блок
+  ck_assert_int_eq(length, 1);
+  ck_assert_int_eq(batched.current_piece.rotation, 1);
+  ck_assert_int_eq(stats.dropped, 3);
+}
+END_TEST
+
+START_TEST(test_coalesce_matches_sequential) {
+  static const UserAction_t ACTIONS[] = {ActionMoveLeft, ActionMoveRight,
+                                         ActionRotate, ActionMoveDown,
+                                         ActionPause};
+  unsigned seed = 9;
+  for (int round = 0; round < 1000; round++) {
+    GameData_t sequential, batched;
+    start_moving_game(&sequential, (uint64_t)round, 6);
+    // Случайные блоки вокруг фигуры и случайный сдвиг, в том числе к стене
+    for (int y = 6; y < BOARD_HEIGHT; y++) {
+      for (int x = 0; x < BOARD_WIDTH; x++) {
+        seed = seed * 1103515245u + 12345u;
+        const CurrentPiece_t *piece = &sequential.current_piece;
+        int row = y - piece->y, col = x - piece->x;
+        bool inside = row >= 0 && row < 4 && col >= 0 && col < 4 &&
+                      piece_cell(piece, row, col);
+        if (!inside && (seed >> 16) % 4 == 0) {
+          set_board_cell(&sequential, x, y, 1);
+        }
+      }
+    }
+    seed = seed * 1103515245u + 12345u;
+    int shift = (int)((seed >> 16) % 11) - 5;
+    for (int i = 0; i < abs(shift); i++) {
+      apply_user_action(&sequential,
+                        shift < 0 ? ActionMoveLeft : ActionMoveRight);
+    }
+    batched = sequential;
+
+    UserAction_t actions[8], out[8];
+    for (int i = 0; i < 8; i++) {
+      seed = seed * 1103515245u + 12345u;
+      actions[i] = ACTIONS[(seed >> 16) % 5];
+    }
+    apply_both(&sequential, &batched, actions, 8, out, NULL);
+  }
+}
+END_TEST
+
+START_TEST(test_coalesce_long_batch) {
+  // Больше COALESCE_CHUNK действий: свертка идет отрезками
+  UserAction_t actions[COALESCE_CHUNK * 3], out[COALESCE_CHUNK * 3];
+  for (int i = 0; i < COALESCE_CHUNK * 3; i++) {
+    actions[i] = i % 3 == 2 ? ActionMoveLeft : ActionRotate;
+  }
+  GameData_t sequential, batched;
+  start_moving_game(&sequential, 7, 6);
+  batched = sequential;
+  InputStats_t stats = {0, 0, 0};
+  int length = apply_both(&sequential, &batched, actions, COALESCE_CHUNK * 3,
+                          out, &stats);
+  ck_assert_int_le(length, COALESCE_CHUNK * 3);
+  ck_assert_int_eq(stats.events, COALESCE_CHUNK * 3);
+}
+END_TEST
+
 //----------------------------------------------------------------------------
 // --- Тесты для функции rotate_piece ---
 // {{0, 0, 0, 0}, {0, 0, 1, 0}, {1, 1, 1, 0}, {0, 0, 0, 0}},  // L
@@ -470,15 +823,15 @@ START_TEST(test_rotate_L_piece_once) {
 
   rotate_piece(&game);
 
-  ck_assert_int_ne(game.current_piece.shape[0][1], 0);
-  ck_assert_int_ne(game.current_piece.shape[1][1], 0);
-  ck_assert_int_ne(game.current_piece.shape[2][1], 0);
-  ck_assert_int_ne(game.current_piece.shape[2][2], 0);
+  ck_assert_int_ne(piece_cell(&game.current_piece, 0, 1), 0);
+  ck_assert_int_ne(piece_cell(&game.current_piece, 1, 1), 0);
+  ck_assert_int_ne(piece_cell(&game.current_piece, 2, 1), 0);
+  ck_assert_int_ne(piece_cell(&game.current_piece, 2, 2), 0);
 
-  ck_assert_int_eq(game.current_piece.shape[0][0], 0);
-  ck_assert_int_eq(game.current_piece.shape[0][2], 0);
-  ck_assert_int_eq(game.current_piece.shape[2][0], 0);
-  ck_assert_int_eq(game.current_piece.shape[2][3], 0);
+  ck_assert_int_eq(piece_cell(&game.current_piece, 0, 0), 0);
+  ck_assert_int_eq(piece_cell(&game.current_piece, 0, 2), 0);
+  ck_assert_int_eq(piece_cell(&game.current_piece, 2, 0), 0);
+  ck_assert_int_eq(piece_cell(&game.current_piece, 2, 3), 0);
 }
 END_TEST
 
@@ -489,15 +842,16 @@ START_TEST(test_rotate_I_piece_full_cycle) {
   setup_game_with_piece(&game, piece_index);
 
   int initial_shape[4][4];
-  memcpy(initial_shape, game.current_piece.shape, sizeof(int) * 16);
+  get_piece_shape(&game.current_piece, initial_shape);
 
   rotate_piece(&game);
   rotate_piece(&game);
   rotate_piece(&game);
   rotate_piece(&game);
 
-  int result =
-      memcmp(initial_shape, game.current_piece.shape, sizeof(int) * 16);
+  int current_shape[4][4];
+  get_piece_shape(&game.current_piece, current_shape);
+  int result = memcmp(initial_shape, current_shape, sizeof(int) * 16);
   ck_assert_int_eq(result, 0);  // Ожидаем, что они идентичны (memcmp вернет 0)
 }
 END_TEST
@@ -509,16 +863,53 @@ START_TEST(test_rotate_O_piece_no_change) {
   setup_game_with_piece(&game, piece_index);
 
   int initial_shape[4][4];
-  memcpy(initial_shape, game.current_piece.shape, sizeof(int) * 16);
+  get_piece_shape(&game.current_piece, initial_shape);
 
   rotate_piece(&game);
 
-  int result =
-      memcmp(initial_shape, game.current_piece.shape, sizeof(int) * 16);
+  int current_shape[4][4];
+  get_piece_shape(&game.current_piece, current_shape);
+  int result = memcmp(initial_shape, current_shape, sizeof(int) * 16);
   ck_assert_int_eq(result, 0);
 }
 END_TEST
 
+START_TEST(test_rotation_tables_match_matrix_rotation) {
+  init_piece_tables();
+  for (int piece = 0; piece < PIECE_COUNT; piece++) {
+    int expected[4][4];
+    memcpy(expected, FIGURES[piece], sizeof(expected));
+    for (int r = 0; r < ROTATION_COUNT; r++) {
+      CurrentPiece_t current = {piece, r, 0, 0, piece + 1};
+      int actual[4][4];
+      get_piece_shape(&current, actual);
+      ck_assert_int_eq(memcmp(expected, actual, sizeof(expected)), 0);
+
+      // Поворот матрицы по часовой стрелке, как в исходной реализации
+      int rotated[4][4];
+      for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) rotated[i][j] = expected[3 - j][i];
+      }
+      memcpy(expected, rotated, sizeof(expected));
+    }
+  }
+}
+END_TEST
+
+START_TEST(test_rotation_tables_x_range) {
+  init_piece_tables();
+  // Горизонтальная 'I' занимает столбцы 0..3 матрицы
+  ck_assert_int_eq(PIECE_ROTATIONS[0][0].min_x, 0);
+  ck_assert_int_eq(PIECE_ROTATIONS[0][0].max_x, BOARD_WIDTH - 4);
+  // Вертикальная 'I' занимает только столбец 1
+  ck_assert_int_eq(PIECE_ROTATIONS[0][1].min_x, -1);
+  ck_assert_int_eq(PIECE_ROTATIONS[0][1].max_x, BOARD_WIDTH - 2);
+  // Маска, сдвинутая к правой стене, заполняет столбцы 6..9
+  ck_assert_int_eq(
+      PIECE_ROTATIONS[0][0].shifted[BOARD_WIDTH - 4 - PIECE_MIN_X][2], 0x3C0);
+}
+END_TEST
+
 //----------------------------------------------------------------------------
 // --- Тесты для функций работы с файлами ---
 
@@ -587,9 +978,11 @@ START_TEST(test_spawn_success) {
 
   int mem_res = -1;
   int idx = 0;
+  int current_shape[4][4];
+  get_piece_shape(&game.current_piece, current_shape);
   // 2. Проверяем, что фигура скопировалась в current_piece
   for (idx = 0; idx < 7; idx++) {
-    mem_res = memcmp(game.current_piece.shape, FIGURES[idx], sizeof(int) * 16);
+    mem_res = memcmp(current_shape, FIGURES[idx], sizeof(int) * 16);
     if (mem_res == 0) {
       break;
     }
@@ -609,7 +1002,7 @@ START_TEST(test_spawn_fail_game_over) {
   game.next_piece_index = 0;  // Будем спавнить 'I'
 
   // Блокируем зону спавна
-  game.board[0][4] = 1;
+  set_board_cell(&game, 4, 0, 1);
 
   bool result = spawn_new_piece(&game);
 
@@ -623,7 +1016,7 @@ END_TEST
 
 START_TEST(test_move_piece_success) {
   GameData_t game;
-  initialize_game(&game);
+  setup_game_with_piece(&game, 0);
   game.current_piece.x = 5;
   game.current_piece.y = 5;
 
@@ -639,7 +1032,7 @@ END_TEST
 
 START_TEST(test_move_piece_fail_wall) {
   GameData_t game;
-  initialize_game(&game);
+  setup_game_with_piece(&game, 0);
   // Ставим фигуру 'I' у левой стены (ее блоки начинаются с x=0)
   game.current_piece.x = 0;
   game.current_piece.y = 5;
@@ -654,10 +1047,10 @@ END_TEST
 
 START_TEST(test_move_piece_fail_block) {
   GameData_t game;
-  initialize_game(&game);
+  setup_game_with_piece(&game, 0);
 
   // Ставим блок на поле
-  game.board[10][5] = 1;
+  set_board_cell(&game, 5, 11, 1);
 
   // Ставим нашу фигуру прямо над ним
   game.current_piece.x = 2;  // Блок фигуры будет на x = 2 + 3 = 5
@@ -671,6 +1064,119 @@ START_TEST(test_move_piece_fail_block) {
 }
 END_TEST
 
+START_TEST(test_slide_piece_stops_at_block) {
+  GameData_t game;
+  setup_game_with_piece(&game, 0);
+  game.current_piece.x = 0;
+  game.current_piece.y = 5;  // Блоки фигуры 'I' в строке 7
+  set_board_cell(&game, 8, 7, 1);
+
+  ck_assert_int_eq(slide_piece(&game, BOARD_WIDTH), 4);
+  ck_assert_int_eq(game.current_piece.x, 4);
+  ck_assert_int_eq(slide_piece(&game, 1), 0);
+  ck_assert_int_eq(slide_piece(&game, -BOARD_WIDTH), 4);
+  ck_assert_int_eq(game.current_piece.x, 0);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// --- Тесты для автоповтора сдвига (press_shift, release_shift) ---
+
+// --- Утилита для тестов: фигура 'I' у левой стены, падение отложено ---
+static void setup_auto_shift(GameData_t *game, int das, int arr) {
+  setup_game_with_piece(game, 0);
+  game->state = Moving;
+  game->current_piece.x = 0;
+  game->current_piece.y = 5;
+  game->timer.next_shift_tick = 100;
+  set_auto_shift(game, das, arr);
+}
+
+START_TEST(test_auto_shift_das_and_arr) {
+  GameData_t game;
+  setup_auto_shift(&game, 2 * SUBTICKS_PER_TICK, SUBTICKS_PER_TICK / 2);
+
+  press_shift(&game, 1, game_subtick(&game, 0));
+  ck_assert_int_eq(game.current_piece.x, 1);
+  update_game_state(&game);
+  update_game_state(&game);
+  ck_assert_int_eq(game.current_piece.x, 1);
+
+  // После задержки — два сдвига за тик
+  update_game_state(&game);
+  ck_assert_int_eq(game.current_piece.x, 3);
+  ck_assert_int_eq(next_event_tick(&game), game.timer.tick);
+
+  // Отпускание в середине тика: выполняется только первый сдвиг тика
+  release_shift(&game, 1, game_subtick(&game, SUBTICKS_PER_TICK / 4));
+  ck_assert_int_eq(game.current_piece.x, 4);
+  update_game_state(&game);
+  ck_assert_int_eq(game.current_piece.x, 4);
+  ck_assert_int_eq(next_event_tick(&game), 100);
+}
+END_TEST
+
+START_TEST(test_auto_shift_zero_arr_reaches_wall) {
+  GameData_t game;
+  setup_auto_shift(&game, 0, 0);
+  game.current_piece.x = 3;
+
+  press_shift(&game, -1, game_subtick(&game, 0));
+  ck_assert_int_eq(game.current_piece.x, 2);
+  update_game_state(&game);
+  ck_assert_int_eq(game.current_piece.x, 0);
+  // У стены сдвигов не ожидается: часы можно пропустить до падения
+  ck_assert_int_eq(next_event_tick(&game), 100);
+
+  // Удержание в другую сторону заменяет текущее
+  press_shift(&game, 1, game_subtick(&game, 0));
+  release_shift(&game, -1, game_subtick(&game, 0));
+  update_game_state(&game);
+  ck_assert_int_eq(game.current_piece.x, PIECE_ROTATIONS[0][0].max_x);
+}
+END_TEST
+
+START_TEST(test_auto_shift_advance_matches_single_steps) {
+  GameData_t stepped, advanced;
+  initialize_game_core(&stepped, 0, 21);
+  set_settle_transitions(&stepped, true);
+  set_auto_shift(&stepped, 20, 3);
+  apply_user_action(&stepped, ActionStart);
+  advanced = stepped;
+
+  unsigned seed = 5;
+  for (int round = 0; round < 2000 && stepped.state != GameOver; round++) {
+    seed = seed * 1103515245u + 12345u;
+    int direction = (seed >> 16) & 1 ? 1 : -1;
+    long time = game_subtick(&stepped, (int)((seed >> 20) % 16));
+    long ticks = 1 + (seed >> 8) % 30;
+    switch ((seed >> 24) % 4) {
+      case 0:
+        press_shift(&stepped, direction, time);
+        press_shift(&advanced, direction, time);
+        break;
+      case 1:
+        release_shift(&stepped, direction, time);
+        release_shift(&advanced, direction, time);
+        break;
+      case 2:
+        apply_user_action(&stepped, ActionRotate);
+        apply_user_action(&advanced, ActionRotate);
+        break;
+    }
+    for (long i = 0; i < ticks; i++) update_game_state(&stepped);
+    advance_game(&advanced, ticks);
+
+    ck_assert_int_eq(advanced.state, stepped.state);
+    ck_assert_int_eq(advanced.timer.tick, stepped.timer.tick);
+    ck_assert_int_eq(advanced.current_piece.x, stepped.current_piece.x);
+    ck_assert_int_eq(advanced.current_piece.y, stepped.current_piece.y);
+    ck_assert_int_eq(
+        memcmp(advanced.rows, stepped.rows, sizeof(stepped.rows)), 0);
+  }
+}
+END_TEST
+
 //----------------------------------------------------------------------------
 // --- Тесты для функции update_game_state ---
 
@@ -691,7 +1197,7 @@ START_TEST(test_update_state_spawn_to_gameover) {
   setup_game_with_piece(&game, 0);
   game.state = Spawn;
   // Блокируем зону спавна
-  game.board[0][4] = 1;
+  set_board_cell(&game, 4, 0, 1);
 
   update_game_state(&game);
 
@@ -740,13 +1246,202 @@ START_TEST(test_update_state_timer_triggers_shifting) {
   game.current_piece.x = 3;
   game.current_piece.y = 5;
 
-  game.timer.ticker = game.timer.speed_threshold + 1;
+  game.timer.tick = 40;
+  game.timer.next_shift_tick = 40;
 
   update_game_state(&game);
 
   ck_assert_int_eq(game.state, Moving);
   ck_assert_int_eq(game.current_piece.y, 6);
-  ck_assert_int_eq(game.timer.ticker, 1);
+  ck_assert_int_eq(game.timer.tick, 41);
+  ck_assert_int_eq(game.timer.next_shift_tick, 40 + gravity_interval(&game));
+}
+END_TEST
+
+START_TEST(test_update_state_waits_for_deadline) {
+  GameData_t game;
+  setup_game_with_piece(&game, 0);
+  game.state = Moving;
+  game.current_piece.y = 5;
+  game.timer.tick = 10;
+  game.timer.next_shift_tick = 12;
+
+  update_game_state(&game);
+  update_game_state(&game);
+  ck_assert_int_eq(game.current_piece.y, 5);
+  update_game_state(&game);
+  ck_assert_int_eq(game.current_piece.y, 6);
+}
+END_TEST
+
+START_TEST(test_gravity_interval_by_level) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 1);
+  ck_assert_int_eq(gravity_interval(&game), 20);
+  game.info.level = MAX_LEVEL;
+  ck_assert_int_eq(gravity_interval(&game), 11);
+  game.timer.speed_threshold = 0;
+  ck_assert_int_eq(gravity_interval(&game), 1);
+}
+END_TEST
+
+START_TEST(test_next_event_tick) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 1);
+  ck_assert_int_eq(next_event_tick(&game), -1);  // Start
+
+  apply_user_action(&game, ActionStart);
+  ck_assert_int_eq(next_event_tick(&game), 0);  // Spawn — сразу
+
+  update_game_state(&game);
+  ck_assert_int_eq(game.state, Moving);
+  ck_assert_int_eq(next_event_tick(&game), gravity_interval(&game));
+
+  apply_user_action(&game, ActionPause);
+  ck_assert_int_eq(next_event_tick(&game), -1);
+  ck_assert_int_eq(skip_to_tick(&game, 100), 1);
+}
+END_TEST
+
+START_TEST(test_skip_to_tick_stops_at_event) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 1);
+  apply_user_action(&game, ActionStart);
+  update_game_state(&game);
+
+  long deadline = next_event_tick(&game);
+  ck_assert_int_eq(skip_to_tick(&game, 1000), deadline);
+  ck_assert_int_eq(skip_to_tick(&game, 5), deadline);  // назад не идет
+  int y = game.current_piece.y;
+  update_game_state(&game);
+  ck_assert_int_eq(game.current_piece.y, y + 1);
+}
+END_TEST
+
+START_TEST(test_advance_game_matches_single_steps) {
+  static const UserAction_t ACTIONS[] = {ActionMoveLeft, ActionMoveRight,
+                                         ActionRotate, ActionMoveDown,
+                                         ActionNone};
+  GameData_t stepped, advanced;
+  initialize_game_core(&stepped, 0, 11);
+  initialize_game_core(&advanced, 0, 11);
+  apply_user_action(&stepped, ActionStart);
+  apply_user_action(&advanced, ActionStart);
+
+  unsigned seed = 1;
+  for (int round = 0; round < 2000 && stepped.state != GameOver; round++) {
+    seed = seed * 1103515245u + 12345u;
+    UserAction_t action = ACTIONS[(seed >> 16) % 5];
+    long ticks = 1 + (seed >> 8) % 30;
+    apply_user_action(&stepped, action);
+    apply_user_action(&advanced, action);
+    for (long i = 0; i < ticks; i++) update_game_state(&stepped);
+    advance_game(&advanced, ticks);
+
+    ck_assert_int_eq(advanced.state, stepped.state);
+    ck_assert_int_eq(advanced.timer.tick, stepped.timer.tick);
+    ck_assert_int_eq(advanced.timer.next_shift_tick,
+                     stepped.timer.next_shift_tick);
+    ck_assert_int_eq(advanced.current_piece.y, stepped.current_piece.y);
+    ck_assert_int_eq(advanced.info.score, stepped.info.score);
+    ck_assert_int_eq(
+        memcmp(advanced.rows, stepped.rows, sizeof(stepped.rows)), 0);
+  }
+}
+END_TEST
+
+START_TEST(test_settle_hard_drop_spawns_next_piece) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 5);
+  set_settle_transitions(&game, true);
+  apply_user_action(&game, ActionStart);
+  update_game_state(&game);
+  ck_assert_int_eq(game.state, Moving);
+  ck_assert_int_eq(game.piece_count, 1);
+
+  int next = game.next_piece_index;
+  apply_user_action(&game, ActionMoveDown);
+  ck_assert_int_eq(game.state, Attaching);
+  update_game_state(&game);
+
+  // Attaching -> Spawn -> Moving за один тик
+  ck_assert_int_eq(game.state, Moving);
+  ck_assert_int_eq(game.timer.tick, 2);
+  ck_assert_int_eq(game.current_piece.piece, next);
+  ck_assert_int_eq(game.piece_count, 2);
+  ck_assert_int_eq(game.timer.next_shift_tick, 1 + gravity_interval(&game));
+}
+END_TEST
+
+START_TEST(test_settle_gravity_landing_in_one_tick) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 5);
+  set_settle_transitions(&game, true);
+  apply_user_action(&game, ActionStart);
+  update_game_state(&game);
+
+  // Фигура стоит на дне: падение по таймеру сразу ведет к новой фигуре
+  for (int y = game.current_piece.y - 1; y != game.current_piece.y;) {
+    y = game.current_piece.y;
+    move_piece(&game, 0, 1);
+  }
+  game.timer.next_shift_tick = game.timer.tick;
+  uint16_t empty[BOARD_HEIGHT] = {0};
+  update_game_state(&game);
+
+  ck_assert_int_eq(game.state, Moving);
+  ck_assert_int_eq(game.piece_count, 2);
+  ck_assert_int_ne(memcmp(game.rows, empty, sizeof(empty)), 0);
+}
+END_TEST
+
+START_TEST(test_settle_off_by_default) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 5);
+  ck_assert(!game.settle_transitions);
+  apply_user_action(&game, ActionStart);
+  update_game_state(&game);
+  apply_user_action(&game, ActionMoveDown);
+
+  update_game_state(&game);
+  ck_assert_int_eq(game.state, Spawn);
+  update_game_state(&game);
+  ck_assert_int_eq(game.state, Moving);
+  ck_assert_int_eq(game.piece_count, 2);
+}
+END_TEST
+
+START_TEST(test_settle_advance_game_matches_single_steps) {
+  static const UserAction_t ACTIONS[] = {ActionMoveLeft, ActionRotate,
+                                         ActionMoveDown, ActionNone};
+  GameData_t stepped, advanced;
+  initialize_game_core(&stepped, 0, 12);
+  initialize_game_core(&advanced, 0, 12);
+  set_settle_transitions(&stepped, true);
+  set_settle_transitions(&advanced, true);
+  apply_user_action(&stepped, ActionStart);
+  apply_user_action(&advanced, ActionStart);
+
+  unsigned seed = 7;
+  for (int round = 0; round < 2000 && stepped.state != GameOver; round++) {
+    seed = seed * 1103515245u + 12345u;
+    UserAction_t action = ACTIONS[(seed >> 16) % 4];
+    long ticks = 1 + (seed >> 8) % 30;
+    apply_user_action(&stepped, action);
+    apply_user_action(&advanced, action);
+    for (long i = 0; i < ticks; i++) {
+      update_game_state(&stepped);
+      ck_assert(stepped.state == Moving || stepped.state == GameOver);
+    }
+    advance_game(&advanced, ticks);
+
+    ck_assert_int_eq(advanced.state, stepped.state);
+    ck_assert_int_eq(advanced.timer.tick, stepped.timer.tick);
+    ck_assert_int_eq(advanced.piece_count, stepped.piece_count);
+    ck_assert_int_eq(advanced.info.score, stepped.info.score);
+    ck_assert_int_eq(
+        memcmp(advanced.rows, stepped.rows, sizeof(stepped.rows)), 0);
+  }
 }
 END_TEST
 
@@ -800,13 +1495,14 @@ START_TEST(test_action_rotation_with_collision_cancel) {
 
   // Сохраняем исходную форму
   int initial_shape[4][4];
-  memcpy(initial_shape, game.current_piece.shape, sizeof(int) * 16);
+  get_piece_shape(&game.current_piece, initial_shape);
 
   apply_user_action(&game, ActionRotate);
 
   // Проверяем, что форма не изменилась, так как вращение было отменено
-  int result =
-      memcmp(initial_shape, game.current_piece.shape, sizeof(int) * 16);
+  int current_shape[4][4];
+  get_piece_shape(&game.current_piece, current_shape);
+  int result = memcmp(initial_shape, current_shape, sizeof(int) * 16);
   ck_assert_int_eq(result, 0);
 }
 END_TEST
@@ -828,6 +1524,80 @@ START_TEST(test_action_hard_drop) {
 }
 END_TEST
 
+START_TEST(test_action_hard_drop_under_overhang) {
+  GameData_t game;
+  setup_game_with_piece(&game, 1);  // 'O': блоки в строках y+1, y+2
+  game.state = Moving;
+  game.current_piece.x = 3;  // Блоки в столбцах 4 и 5
+  game.current_piece.y = 10;
+  set_board_cell(&game, 4, 5, 1);  // Навес над фигурой
+  set_board_cell(&game, 5, 16, 1);
+
+  apply_user_action(&game, ActionMoveDown);
+  ck_assert_int_eq(game.current_piece.y, 13);
+}
+END_TEST
+
+// --- Утилита для тестов: высота столбца перебором клеток ---
+static int scan_height(const GameData_t *game, int x) {
+  for (int y = 0; y < BOARD_HEIGHT; y++) {
+    if (game->board[y][x]) return BOARD_HEIGHT - y;
+  }
+  return 0;
+}
+
+START_TEST(test_heights_follow_board_changes) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 1);
+  unsigned seed = 11;
+  for (int step = 0; step < 5000; step++) {
+    seed = seed * 1103515245u + 12345u;
+    int x = (int)((seed >> 16) % BOARD_WIDTH);
+    int y = (int)((seed >> 8) % BOARD_HEIGHT);
+    if (step % 50 == 49) {
+      // Заполняем строку целиком, чтобы clear_lines было что очищать
+      for (int col = 0; col < BOARD_WIDTH; col++) {
+        set_board_cell(&game, col, y, 1);
+      }
+      clear_lines(&game);
+    } else {
+      set_board_cell(&game, x, y, (seed >> 4) % 3 ? 1 : 0);
+    }
+    for (int col = 0; col < BOARD_WIDTH; col++) {
+      ck_assert_int_eq(game.heights[col], scan_height(&game, col));
+    }
+  }
+}
+END_TEST
+
+START_TEST(test_drop_distance_matches_sweep) {
+  GameData_t game;
+  initialize_game_core(&game, 0, 1);
+  unsigned seed = 29;
+  for (int round = 0; round < 5000; round++) {
+    seed = seed * 1103515245u + 12345u;
+    if (round % 100 == 0) {
+      initialize_game_core(&game, 0, 1);
+      for (int cell = 0; cell < 60; cell++) {
+        seed = seed * 1103515245u + 12345u;
+        set_board_cell(&game, (int)((seed >> 16) % BOARD_WIDTH),
+                       6 + (int)((seed >> 8) % (BOARD_HEIGHT - 6)), 1);
+      }
+    }
+    game.current_piece.piece = (int)((seed >> 16) % PIECE_COUNT);
+    game.current_piece.rotation = (int)((seed >> 12) % ROTATION_COUNT);
+    game.current_piece.x = (int)((seed >> 20) % PIECE_X_SLOTS) + PIECE_MIN_X;
+    game.current_piece.y = (int)((seed >> 4) % 22) - 2;
+    if (check_collision(&game)) continue;
+
+    GameData_t swept = game;
+    while (!check_collision(&swept)) swept.current_piece.y++;
+    ck_assert_int_eq(drop_distance(&game),
+                     swept.current_piece.y - 1 - game.current_piece.y);
+  }
+}
+END_TEST
+
 START_TEST(test_action_ignored_in_wrong_state) {
   GameData_t game;
   initialize_game(&game);  // game.state == Start
@@ -847,6 +1617,11 @@ Suite *tetris_suite_create(void) {
   /// --- Тесты генерации фигур ---
   TCase *tc_generation = tcase_create("Generation");
   tcase_add_test(tc_generation, test_generate_new_shape_range);
+  tcase_add_test(tc_generation, test_generate_same_seed_same_sequence);
+  tcase_add_test(tc_generation, test_generate_different_seeds_differ);
+  tcase_add_test(tc_generation, test_generate_bag7_contains_every_piece);
+  tcase_add_test(tc_generation, test_preview_keeps_piece_sequence);
+  tcase_add_test(tc_generation, test_preview_length_is_clamped);
   suite_add_tcase(s, tc_generation);
 
   /// --- Тесты столкновений ---
@@ -870,6 +1645,7 @@ Suite *tetris_suite_create(void) {
   tcase_add_test(tc_lines, test_clear_one_bottom_line);
   tcase_add_test(tc_lines, test_clear_four_lines_tetris);
   tcase_add_test(tc_lines, test_clear_line_in_the_middle);
+  tcase_add_test(tc_lines, test_clear_split_lines);
   suite_add_tcase(s, tc_lines);
 
   // --- Тесты обработки очков и повышения уровня ---
@@ -899,6 +1675,14 @@ Suite *tetris_suite_create(void) {
   tcase_add_test(tc_actions, test_get_action_movement);
   tcase_add_test(tc_actions, test_get_action_game_control);
   tcase_add_test(tc_actions, test_get_action_special_cases);
+  tcase_add_test(tc_actions, test_coalesce_net_horizontal_shift);
+  tcase_add_test(tc_actions, test_coalesce_rotations_and_pauses);
+  tcase_add_test(tc_actions, test_coalesce_drops_after_hard_drop);
+  tcase_add_test(tc_actions, test_coalesce_start_after_ignored_drop);
+  tcase_add_test(tc_actions, test_coalesce_blocked_shift);
+  tcase_add_test(tc_actions, test_coalesce_blocked_rotation);
+  tcase_add_test(tc_actions, test_coalesce_matches_sequential);
+  tcase_add_test(tc_actions, test_coalesce_long_batch);
   suite_add_tcase(s, tc_actions);
 
   // --- Тесты для функции rotate_piece ---
@@ -906,6 +1690,8 @@ Suite *tetris_suite_create(void) {
   tcase_add_test(tc_rotation, test_rotate_L_piece_once);
   tcase_add_test(tc_rotation, test_rotate_I_piece_full_cycle);
   tcase_add_test(tc_rotation, test_rotate_O_piece_no_change);
+  tcase_add_test(tc_rotation, test_rotation_tables_match_matrix_rotation);
+  tcase_add_test(tc_rotation, test_rotation_tables_x_range);
   suite_add_tcase(s, tc_rotation);
 
   // --- Тесты для функций работы с файлами ---
@@ -926,8 +1712,16 @@ Suite *tetris_suite_create(void) {
   tcase_add_test(tc_move, test_move_piece_success);
   tcase_add_test(tc_move, test_move_piece_fail_wall);
   tcase_add_test(tc_move, test_move_piece_fail_block);
+  tcase_add_test(tc_move, test_slide_piece_stops_at_block);
   suite_add_tcase(s, tc_move);
 
+  // --- Тесты для автоповтора сдвига ---
+  TCase *tc_auto_shift = tcase_create("Auto Shift");
+  tcase_add_test(tc_auto_shift, test_auto_shift_das_and_arr);
+  tcase_add_test(tc_auto_shift, test_auto_shift_zero_arr_reaches_wall);
+  tcase_add_test(tc_auto_shift, test_auto_shift_advance_matches_single_steps);
+  suite_add_tcase(s, tc_auto_shift);
+
   // --- Тесты для функции update_game_state ---
   TCase *tc_fsm = tcase_create("Finite State Machine");
   tcase_add_test(tc_fsm, test_update_state_spawn_to_moving);
@@ -935,6 +1729,15 @@ Suite *tetris_suite_create(void) {
   tcase_add_test(tc_fsm, test_update_state_shifting_to_attaching);
   tcase_add_test(tc_fsm, test_update_state_attaching_to_spawn);
   tcase_add_test(tc_fsm, test_update_state_timer_triggers_shifting);
+  tcase_add_test(tc_fsm, test_update_state_waits_for_deadline);
+  tcase_add_test(tc_fsm, test_gravity_interval_by_level);
+  tcase_add_test(tc_fsm, test_next_event_tick);
+  tcase_add_test(tc_fsm, test_skip_to_tick_stops_at_event);
+  tcase_add_test(tc_fsm, test_advance_game_matches_single_steps);
+  tcase_add_test(tc_fsm, test_settle_hard_drop_spawns_next_piece);
+  tcase_add_test(tc_fsm, test_settle_gravity_landing_in_one_tick);
+  tcase_add_test(tc_fsm, test_settle_off_by_default);
+  tcase_add_test(tc_fsm, test_settle_advance_game_matches_single_steps);
   suite_add_tcase(s, tc_fsm);
 
   TCase *tc_user_input = tcase_create("User Input Handling");
@@ -942,6 +1745,9 @@ Suite *tetris_suite_create(void) {
   tcase_add_test(tc_user_input, test_action_pause_and_terminate);
   tcase_add_test(tc_user_input, test_action_rotation_with_collision_cancel);
   tcase_add_test(tc_user_input, test_action_hard_drop);
+  tcase_add_test(tc_user_input, test_action_hard_drop_under_overhang);
+  tcase_add_test(tc_user_input, test_heights_follow_board_changes);
+  tcase_add_test(tc_user_input, test_drop_distance_matches_sweep);
   tcase_add_test(tc_user_input, test_action_ignored_in_wrong_state);
   suite_add_tcase(s, tc_user_input);
 
@@ -952,6 +1758,15 @@ int main(void) {
   int number_failed;
   Suite *s = tetris_suite_create();
   SRunner *sr = srunner_create(s);
+  srunner_add_suite(sr, batch_suite_create());
+  srunner_add_suite(sr, movegen_suite_create());
+  srunner_add_suite(sr, recorder_suite_create());
+  srunner_add_suite(sr, frame_suite_create());
+  srunner_add_suite(sr, ansi_suite_create());
+  srunner_add_suite(sr, undo_suite_create());
+  srunner_add_suite(sr, ttable_suite_create());
+  srunner_add_suite(sr, ai_suite_create());
+  srunner_add_suite(sr, view_suite_create());
   srunner_set_fork_status(sr, CK_NOFORK);
   srunner_run_all(sr, CK_NORMAL);
   number_failed = srunner_ntests_failed(sr);
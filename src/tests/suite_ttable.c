@@ -0,0 +1,138 @@
+#include "brickgame/tetris/perft.h"
+#include "tests/suites.h"
+
+//----------------------------------------------------------------------------
+// --- Тесты хэша Зобриста ---
+
+START_TEST(test_hash_tracks_board) {
+  GameData_t game, other;
+  initialize_game_core(&game, 0, 21);
+  initialize_game_core(&other, 0, 22);
+  ck_assert_uint_eq(game.hash, 0);
+
+  // Строки 18 и 19 заполняются и очищаются, блоки сверху сдвигаются
+  for (int x = 0; x < BOARD_WIDTH; x++) {
+    set_board_cell(&game, x, 19, 1);
+    set_board_cell(&game, x, 18, 2);
+  }
+  set_board_cell(&game, 4, 17, 3);
+  set_board_cell(&game, 6, 15, 4);
+  ck_assert_uint_eq(game.hash, board_hash(&game));
+  ck_assert_int_eq(clear_lines(&game), 2);
+  ck_assert_uint_eq(game.hash, board_hash(&game));
+
+  // Хэш зависит от занятости клеток, но не от их цвета
+  set_board_cell(&other, 4, 19, 5);
+  set_board_cell(&other, 6, 17, 6);
+  ck_assert_uint_eq(other.hash, game.hash);
+  set_board_cell(&other, 4, 19, 7);
+  ck_assert_uint_eq(other.hash, game.hash);
+  set_board_cell(&other, 4, 19, 0);
+  ck_assert_uint_ne(other.hash, game.hash);
+  ck_assert_uint_eq(other.hash, board_hash(&other));
+}
+END_TEST
+
+START_TEST(test_hash_same_board_different_order) {
+  GameData_t first, second;
+  initialize_game_core(&first, 0, 23);
+  initialize_game_core(&second, 0, 23);
+
+  // Две вертикальные палки I у разных стен в разном порядке
+  CurrentPiece_t left = {0, 1, -1, 16, 1}, right = {0, 1, 8, 16, 1};
+  first.current_piece = left;
+  imprint_piece_to_board(&first);
+  first.current_piece = right;
+  imprint_piece_to_board(&first);
+  second.current_piece = right;
+  imprint_piece_to_board(&second);
+  second.current_piece = left;
+  imprint_piece_to_board(&second);
+  ck_assert_uint_eq(first.hash, second.hash);
+  ck_assert_uint_ne(first.hash, 0);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// --- Тесты таблицы транспозиций ---
+
+START_TEST(test_ttable_key_mixes_pieces_and_depth) {
+  uint64_t key = ttable_key(12345, 1, 2, 3);
+  ck_assert_uint_ne(key, ttable_key(12345, 2, 1, 3));
+  ck_assert_uint_ne(key, ttable_key(12345, 1, 2, 4));
+  ck_assert_uint_ne(key, ttable_key(12345, 1, TTABLE_NO_PIECE, 3));
+  ck_assert_uint_ne(key, ttable_key(12346, 1, 2, 3));
+  ck_assert_uint_eq(key, ttable_key(12345, 1, 2, 3));
+  ck_assert_uint_ne(ttable_key(0, 0, 0, 0), 0);
+}
+END_TEST
+
+START_TEST(test_ttable_bucket_replacement) {
+  // Таблица из одной корзины: все ключи попадают в нее
+  TTable_t *table = ttable_create(sizeof(TTableBucket_t));
+  ck_assert_ptr_nonnull(table);
+  ck_assert_uint_eq(table->mask, 0);
+  ck_assert_uint_eq((uintptr_t)table->buckets % 64, 0);
+  ck_assert_uint_eq(sizeof(TTableBucket_t), 64);
+
+  int64_t value = 0;
+  ck_assert(!ttable_probe(table, 1, &value));
+  for (uint64_t key = 1; key <= TTABLE_WAYS; key++) {
+    ttable_store(table, key, (int64_t)key * 10);
+  }
+  // Повторная запись ключа 1 делает его самым свежим без дубликата
+  ttable_store(table, 1, 11);
+  ttable_store(table, TTABLE_WAYS + 1, 50);
+  ck_assert(ttable_probe(table, 1, &value));
+  ck_assert_int_eq(value, 11);
+  ck_assert(!ttable_probe(table, 2, &value));
+  ck_assert(ttable_probe(table, TTABLE_WAYS + 1, &value));
+  ck_assert_int_eq(value, 50);
+  ck_assert_int_eq(table->hits, 2);
+  ck_assert_int_eq(table->probes, 4);
+
+  ttable_clear(table);
+  ck_assert(!ttable_probe(table, 1, &value));
+  ck_assert_int_eq(table->probes, 1);
+  ttable_destroy(table);
+}
+END_TEST
+
+START_TEST(test_perft_cached_matches_perft) {
+  // Эталонные значения для seed = 1 (очередь T T I)
+  static const uint64_t expected[] = {1, 34, 1178, 20868};
+  static MoveGen_t gens[3];
+  GameData_t game;
+  initialize_game_core(&game, 0, 1);
+  int queue[3];
+  perft_queue(&game, queue, 3);
+
+  TTable_t *table = ttable_create(1 << 20);
+  ck_assert_ptr_nonnull(table);
+  for (int depth = 0; depth <= 3; depth++) {
+    ck_assert_uint_eq(perft_cached(gens, table, &game, queue, depth),
+                      expected[depth]);
+  }
+  ck_assert_int_gt(table->hits, 0);
+  ttable_destroy(table);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// Создание тестового набора для хэшей и таблицы транспозиций
+Suite *ttable_suite_create(void) {
+  Suite *s = suite_create("TTable");
+
+  TCase *tc_hash = tcase_create("Zobrist");
+  tcase_add_test(tc_hash, test_hash_tracks_board);
+  tcase_add_test(tc_hash, test_hash_same_board_different_order);
+  suite_add_tcase(s, tc_hash);
+
+  TCase *tc_table = tcase_create("Table");
+  tcase_add_test(tc_table, test_ttable_key_mixes_pieces_and_depth);
+  tcase_add_test(tc_table, test_ttable_bucket_replacement);
+  tcase_add_test(tc_table, test_perft_cached_matches_perft);
+  suite_add_tcase(s, tc_table);
+
+  return s;
+}
@@ -0,0 +1,131 @@
+#include "brickgame/tetris/movegen.h"
+#include "brickgame/tetris/undo.h"
+#include "tests/suites.h"
+
+#define UNDO_TEST_DEPTH 40
+
+// --- Утилита для тестов: сравнивает все, что меняет фиксация фигуры ---
+static void assert_same_game(const GameData_t *a, const GameData_t *b) {
+  ck_assert_mem_eq(a->rows, b->rows, sizeof(a->rows));
+  ck_assert_mem_eq(a->board, b->board, sizeof(a->board));
+  ck_assert_mem_eq(a->heights, b->heights, sizeof(a->heights));
+  ck_assert_uint_eq(a->full_rows, b->full_rows);
+  ck_assert_uint_eq(a->hash, b->hash);
+  ck_assert_int_eq(a->info.score, b->info.score);
+  ck_assert_int_eq(a->info.high_score, b->info.high_score);
+  ck_assert_int_eq(a->info.level, b->info.level);
+  ck_assert_mem_eq(&a->current_piece, &b->current_piece,
+                   sizeof(a->current_piece));
+}
+
+//----------------------------------------------------------------------------
+// --- Тесты журнала отмены ---
+
+START_TEST(test_undo_matches_play_placement) {
+  static MoveGen_t gen;
+  static GameData_t snapshots[UNDO_TEST_DEPTH];
+  static UndoStack_t stack;
+  GameData_t game;
+  initialize_game_core(&game, 0, 11);
+  undo_reset(&stack);
+
+  int depth = 0, clears = 0;
+  unsigned choice = 7;
+  while (depth < UNDO_TEST_DEPTH) {
+    int count = generate_spawn_placements(&gen, &game, depth % PIECE_COUNT);
+    if (!count) break;
+    // Самое низкое положение, при равенстве — случайное: поле не
+    // переполняется и линии очищаются
+    choice = choice * 1103515245u + 12345u;
+    int start = (int)((choice >> 16) % (unsigned)count), index = start;
+    for (int k = 0; k < count; k++) {
+      int i = (start + k) % count;
+      if (gen.placements[i].y > gen.placements[index].y) index = i;
+    }
+
+    snapshots[depth] = game;
+    GameData_t expected = game;
+    play_placement(&expected, &gen, index);
+    ck_assert(undo_place_piece(&stack, &game, placement_piece(&gen, index)));
+    assert_same_game(&game, &expected);
+    if (stack.entries[depth].cleared) clears++;
+    depth++;
+  }
+  ck_assert_int_eq(depth, UNDO_TEST_DEPTH);
+  ck_assert_int_gt(clears, 0);
+  ck_assert_int_eq(stack.depth, depth);
+
+  while (depth > 0) {
+    uint32_t version = game.board_version;
+    undo_restore(&stack, &game);
+    depth--;
+    assert_same_game(&game, &snapshots[depth]);
+    ck_assert_uint_gt(game.board_version, version);
+  }
+  ck_assert_int_eq(stack.depth, 0);
+}
+END_TEST
+
+START_TEST(test_undo_restores_cleared_lines) {
+  static UndoStack_t stack;
+  GameData_t game;
+  initialize_game_core(&game, 0, 12);
+  // Три неполные строки с дыркой в столбце 0 и неполная строка между ними
+  for (int y = 16; y < BOARD_HEIGHT; y++) {
+    for (int x = 1; x < BOARD_WIDTH; x++) {
+      if (y != 18 || x % 2) set_board_cell(&game, x, y, y - 14);
+    }
+  }
+  set_board_cell(&game, 0, 15, 7);
+  GameData_t before = game;
+
+  undo_reset(&stack);
+  // Вертикальная палка I в столбце 0 закрывает строки 16, 17 и 19
+  CurrentPiece_t piece = {0, 1, -1, 16, 1};
+  ck_assert(undo_place_piece(&stack, &game, piece));
+  ck_assert_int_eq(game.info.score, 700);
+  ck_assert_int_eq(game.board[19][0], 1);
+  ck_assert_int_eq(game.board[18][0], 7);
+  ck_assert_uint_eq(game.rows[17], 0);
+
+  undo_restore(&stack, &game);
+  assert_same_game(&game, &before);
+}
+END_TEST
+
+START_TEST(test_undo_rejects_full_stack_and_full_rows) {
+  static UndoStack_t stack;
+  GameData_t game;
+  initialize_game_core(&game, 0, 13);
+  undo_reset(&stack);
+  stack.depth = UNDO_MAX_DEPTH;
+  CurrentPiece_t piece = {1, 0, 3, 10, 2};
+  ck_assert(!undo_place_piece(&stack, &game, piece));
+  ck_assert_int_eq(game.board_version, 0);
+
+  undo_reset(&stack);
+  for (int x = 0; x < BOARD_WIDTH; x++) set_board_cell(&game, x, 19, 1);
+  GameData_t before = game;
+  ck_assert(!undo_place_piece(&stack, &game, piece));
+  ck_assert_int_eq(stack.depth, 0);
+  assert_same_game(&game, &before);
+
+  // Отмена на пустом стеке ничего не делает
+  undo_restore(&stack, &game);
+  assert_same_game(&game, &before);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// Создание тестового набора для журнала отмены
+Suite *undo_suite_create(void) {
+  Suite *s = suite_create("Undo");
+
+  TCase *tc_undo = tcase_create("Journal");
+  tcase_add_test(tc_undo, test_undo_matches_play_placement);
+  tcase_add_test(tc_undo, test_undo_restores_cleared_lines);
+  tcase_add_test(tc_undo, test_undo_rejects_full_stack_and_full_rows);
+  suite_add_tcase(s, tc_undo);
+
+  return s;
+}
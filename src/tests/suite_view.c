@@ -0,0 +1,85 @@
+#include "gui/cli/view.h"
+#include "tests/suites.h"
+
+// --- Утилита для тестов: символ, который ncurses считает выведенным ---
+static int shown_char(int y, int x) {
+  return (int)(mvwinch(curscr, y, x) & A_CHARTEXT);
+}
+
+//----------------------------------------------------------------------------
+// --- Тесты вывода ncurses ---
+
+START_TEST(test_static_elements_survive_input) {
+  FILE *output = tmpfile();
+  ck_assert_ptr_nonnull(output);
+  Renderer_t renderer;
+  ncurses_renderer(&renderer, output);
+  ck_assert(renderer.init(&renderer));
+  NcursesView_t *view = renderer.state;
+
+  GameData_t game;
+  initialize_game_core(&game, 0, 41);
+  renderer.draw(&renderer, &game);
+  // Чтение клавиши не должно затирать окна пустым stdscr
+  renderer.read_key(&renderer);
+  apply_user_action(&game, ActionStart);
+  update_game_state(&game);
+  renderer.draw(&renderer, &game);
+  renderer.read_key(&renderer);
+
+  int corner = (int)(mvwinch(view->win_board, 0, 0) & A_CHARTEXT);
+  ck_assert_int_ne(corner, ' ');
+  ck_assert_int_eq(shown_char(BOARD_WINDOW_Y, BOARD_WINDOW_X), corner);
+  ck_assert_int_eq(shown_char(INFO_WINDOW_Y, INFO_WINDOW_X), corner);
+  const char *label = "Next:";
+  for (int i = 0; label[i]; i++) {
+    ck_assert_int_eq(shown_char(INFO_WINDOW_Y + 7, INFO_WINDOW_X + 2 + i),
+                     label[i]);
+  }
+  const char *score = "Score:";
+  for (int i = 0; score[i]; i++) {
+    ck_assert_int_eq(shown_char(INFO_WINDOW_Y + 2, INFO_WINDOW_X + 2 + i),
+                     score[i]);
+  }
+
+  renderer.cleanup(&renderer);
+  fclose(output);
+}
+END_TEST
+
+START_TEST(test_read_key_uses_board_window) {
+  FILE *output = tmpfile();
+  ck_assert_ptr_nonnull(output);
+  Renderer_t renderer;
+  ncurses_renderer(&renderer, output);
+  ck_assert(renderer.init(&renderer));
+  NcursesView_t *view = renderer.state;
+  ck_assert(is_keypad(view->win_board));
+  ck_assert(is_nodelay(view->win_board));
+
+  GameData_t game;
+  initialize_game_core(&game, 0, 42);
+  renderer.draw(&renderer, &game);
+  long bytes = ftell(output);
+  // Ввода нет: чтение сразу возвращает ERR и ничего не выводит
+  ck_assert_int_eq(renderer.read_key(&renderer), ERR);
+  fflush(output);
+  ck_assert_int_eq(ftell(output), bytes);
+
+  renderer.cleanup(&renderer);
+  fclose(output);
+}
+END_TEST
+
+//----------------------------------------------------------------------------
+// Создание тестового набора для вывода ncurses
+Suite *view_suite_create(void) {
+  Suite *s = suite_create("View");
+
+  TCase *tc_view = tcase_create("Ncurses");
+  tcase_add_test(tc_view, test_static_elements_survive_input);
+  tcase_add_test(tc_view, test_read_key_uses_board_window);
+  suite_add_tcase(s, tc_view);
+
+  return s;
+}
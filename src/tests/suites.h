@@ -0,0 +1,17 @@
+#ifndef TESTS_SUITES_H
+#define TESTS_SUITES_H
+
+#include <check.h>
+
+Suite *tetris_suite_create(void);
+Suite *batch_suite_create(void);
+Suite *movegen_suite_create(void);
+Suite *recorder_suite_create(void);
+Suite *frame_suite_create(void);
+Suite *ansi_suite_create(void);
+Suite *undo_suite_create(void);
+Suite *ttable_suite_create(void);
+Suite *ai_suite_create(void);
+Suite *view_suite_create(void);
+
+#endif